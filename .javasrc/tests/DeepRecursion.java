@@ -0,0 +1,13 @@
+class DeepRecursion {
+    public static void main(String[] args) {
+        // recursões fundas mas que cabem na pilha padrão
+        System.out.println(depth(1000));
+        System.out.println(depth(5000));
+        // essa não cabe, a jvm tem que parar com Stack Overflow e não segfault
+        System.out.println(depth(1000000));
+    }
+
+    static int depth(int n) {
+        return n == 0 ? 0 : depth(n - 1) + 1;
+    }
+}
@@ -0,0 +1,61 @@
+class MatrixBenchmark {
+    static int[][] multiply(int[][] a, int[][] b, int n) {
+        int[][] c = new int[n][n];
+        for (int i = 0; i < n; i++) {
+            for (int k = 0; k < n; k++) {
+                int aik = a[i][k];
+                for (int j = 0; j < n; j++) {
+                    c[i][j] += aik * b[k][j];
+                }
+            }
+        }
+        return c;
+    }
+
+    static double[][] multiply(double[][] a, double[][] b, int n) {
+        double[][] c = new double[n][n];
+        for (int i = 0; i < n; i++) {
+            for (int k = 0; k < n; k++) {
+                double aik = a[i][k];
+                for (int j = 0; j < n; j++) {
+                    c[i][j] += aik * b[k][j];
+                }
+            }
+        }
+        return c;
+    }
+
+    public static void main(String[] args) {
+        int n = 64;
+        int rounds = 5;
+        int[][] a = new int[n][n];
+        int[][] b = new int[n][n];
+        double[][] x = new double[n][n];
+        double[][] y = new double[n][n];
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                a[i][j] = i + j;
+                b[i][j] = i - j;
+                x[i][j] = (i + j) / 2.0;
+                y[i][j] = (i - j) / 4.0;
+            }
+        }
+
+        long isum = 0;
+        double dsum = 0;
+        for (int r = 0; r < rounds; r++) {
+            long start = System.nanoTime();
+            int[][] c = multiply(a, b, n);
+            long middle = System.nanoTime();
+            double[][] z = multiply(x, y, n);
+            long end = System.nanoTime();
+            System.out.println("round " + r + ": int[][] " +
+                               (middle - start) / 1000000 + " ms, double[][] " +
+                               (end - middle) / 1000000 + " ms");
+            isum += c[r][n - 1 - r];
+            dsum += z[r][n - 1 - r];
+        }
+        System.out.println(isum);
+        System.out.println(dsum);
+    }
+}
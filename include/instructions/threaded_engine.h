@@ -0,0 +1,68 @@
+#ifndef INCLUDE_INSTRUCTIONS_THREADED_ENGINE_H_
+#define INCLUDE_INSTRUCTIONS_THREADED_ENGINE_H_
+
+#include <vector>
+
+#include "utils/attributes.h"
+#include "utils/types.h"
+
+// forward declaration
+namespace MemoryAreas {
+class Thread;
+}
+
+namespace Instructions {
+/**
+ * @brief one bytecode instruction after decoding. The operands are parsed
+ * once and every branch target is already an index into DecodedMethod::code
+ */
+struct DecodedInstruction {
+  // endereço do label que executa a instrução, preenchido no primeiro run
+  const void *handler;
+  Utils::Types::u1 opcode;
+  bool wide;
+  // offset da instrução no Code_attribute::code original
+  int pc;
+  int a;
+  int b;
+};
+
+struct SwitchTable {
+  int default_target;
+  int low;
+  // usado apenas pelo lookupswitch, ordenado pra busca binária
+  std::vector<int> keys;
+  std::vector<int> targets;
+};
+
+struct DecodedMethod {
+  std::vector<DecodedInstruction> code;
+  // pc do bytecode -> índice em code, -1 se o pc cai no meio de uma instrução
+  std::vector<int> index_of_pc;
+  std::vector<SwitchTable> switches;
+  std::vector<Utils::Types::u1> *bytecode;
+  bool linked;
+};
+
+/**
+ * @brief decode the method bytecode into a compact instruction stream
+ *
+ * @param code_attr
+ * @return DecodedMethod*
+ */
+DecodedMethod *decodeMethod(Utils::Attributes::Code_attribute *code_attr);
+
+/**
+ * @brief run a decoded method with direct-threaded dispatch, starting at the
+ * instruction of index start, until a return instruction is executed or an
+ * instruction leaves an exception pending in the thread
+ *
+ * @param method
+ * @param th
+ * @param start
+ */
+void runDecoded(DecodedMethod *method, MemoryAreas::Thread *th,
+                const int &start);
+}  // namespace Instructions
+
+#endif  // INCLUDE_INSTRUCTIONS_THREADED_ENGINE_H_
@@ -4,7 +4,9 @@
 #include <string>
 #include <vector>
 
+#include "utils/flags.h"
 #include "utils/frame.h"
+#include "utils/memory_areas/class_registry.h"
 #include "utils/memory_areas/heap.h"
 #include "utils/memory_areas/java_stack.h"
 #include "utils/memory_areas/method_area.h"
@@ -15,20 +17,33 @@ class Interpreter {
   Interpreter(const ClassFile *cf, const std::string &fname) {
     this->classname = fname;
     this->entry_class = cf;
-    this->init();
+    this->classes = nullptr;
+    this->method_area = nullptr;
+    this->heap = nullptr;
   }
 
   ~Interpreter() {
+    if (Utils::Flags::options.kPROFILE_ALLOCATIONS) {
+      this->reportAllocations();
+    }
     delete this->method_area;
     delete this->heap;
+    delete this->classes;
   }
 
+  // carrega a classe e executa o main numa thread nativa com a pilha
+  // proporcional ao -Xss
   void run();
 
  private:
   void init();
+  void execute();
+
+  // relatorio das alocações de todas as threads, no stderr e em json
+  void reportAllocations();
 
   std::vector<MemoryAreas::Thread> threads;
+  MemoryAreas::ClassRegistry *classes;
   MemoryAreas::MethodArea *method_area;
   MemoryAreas::Heap *heap;
   std::string classname;
@@ -2,7 +2,7 @@
 #define INCLUDE_READER_H_
 
 #include <algorithm>
-#include <fstream>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -14,11 +14,7 @@ class Reader {
  public:
   explicit Reader(ClassFile *cf, const std::string &fpath);
 
-  ~Reader() {
-    if (this->file.is_open()) {
-      this->file.close();
-    }
-  }
+  ~Reader() = default;
 
   void readClassFile();
   std::string fname;
@@ -53,18 +49,39 @@ class Reader {
   void readAttributesInfo(
       std::vector<Utils::Attributes::attribute_info> *attributes);
 
-  template <class T>
-  inline void endianSwap(T *objp) {
-    auto memp = reinterpret_cast<unsigned char *>(objp);
-    std::reverse(memp, memp + sizeof(T));
+  void checkBounds(const size_t &size) {
+    if (size > this->buffer.size() - this->position) {
+      throw Utils::Errors::Exception(
+          Utils::Errors::kCLASSFILE,
+          "classfile: " + this->fname + " is truncated at byte " +
+              std::to_string(this->position));
+    }
   }
 
+  // decodifica um valor big-endian direto do buffer
   template <typename T>
   inline void readBytes(T *objp, const bool &flip = true) {
-    this->file.read(reinterpret_cast<char *>(objp), sizeof(T));
+    this->checkBounds(sizeof(T));
+    auto bytes = &this->buffer[this->position];
     if (flip) {
-      this->endianSwap(objp);
+      T value = 0;
+      for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((value << 8) | bytes[i]);
+      }
+      *objp = value;
+    } else {
+      std::memcpy(objp, bytes, sizeof(T));
     }
+    this->position += sizeof(T);
+  }
+
+  // copia count bytes de uma vez, usado no array de bytecode
+  inline void readBytes(std::vector<Utils::Types::u1> *bytes,
+                        const size_t &count) {
+    this->checkBounds(count);
+    bytes->assign(this->buffer.begin() + this->position,
+                  this->buffer.begin() + this->position + count);
+    this->position += count;
   }
 
   void kpoolValidEntry(const Utils::Types::u2 &index,
@@ -88,7 +105,9 @@ class Reader {
     return kinfo;
   }
 
-  std::fstream file;
+  // o arquivo inteiro, lido com uma única chamada
+  std::vector<Utils::Types::u1> buffer;
+  size_t position;
   ClassFile *classfile;
   std::string path;
 };
@@ -1,53 +1,116 @@
 #ifndef INCLUDE_UTILS_ARRAY_T_H_
 #define INCLUDE_UTILS_ARRAY_T_H_
 
-#include <list>
-#include <stack>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
 
-#include "utils/external/any.h"
+#include "utils/errors.h"
 #include "utils/reference_kind.h"
+#include "utils/types.h"
 
 namespace Utils {
+struct Object;
+
+/**
+ * @brief a java array. The elements live unboxed in a single contiguous
+ * buffer, the size of each one is given by the atype of newarray (a byte[]
+ * uses 1 byte per element, a long[] 8) and every other type is an array of
+ * references. Every access is O(1) and checks the bounds.
+ *
+ * The buffer may be a piece of a block shared with other arrays: the rows of
+ * the last dimension of a multianewarray are laid out one after the other in
+ * a single block, so a matrix is traversed in row-major order without
+ * leaving it. The block lives while any of its rows does
+ */
 class Array_t {
  public:
-  Array_t(const int &max_len, const int &atype) : items(max_len) {
-    this->max_length = max_len;
-    this->type = atype;
-  }
+  Array_t(const int &length, const int &atype);
 
-  Array_t(const int &max_len) : items(max_len) { this->max_length = max_len; }
+  // array de referencias
+  explicit Array_t(const int &length)
+      : Array_t(length, Utils::Reference::kREF_CLASS) {}
+
+  /**
+   * @brief an array whose elements are in a block shared with other arrays
+   *
+   * @param length
+   * @param atype
+   * @param block
+   * @param offset where the first element is in the block, in bytes
+   */
+  Array_t(const int &length, const int &atype,
+          const std::shared_ptr<std::vector<Types::u1>> &block,
+          const size_t &offset);
 
   ~Array_t() = default;
 
   template <typename T>
-  void insert(T value, int index) {
-    auto element = std::next(this->items.begin(), index);
-    *element = value;
+  void insert(const T &value, const int &index) {
+    std::memcpy(this->element<T>(index), &value, sizeof(T));
   }
 
-  int length() { return this->items.size(); }
+  int length() { return this->size; }
 
   template <typename T>
   T get(const int &index) {
-    auto element = std::next(this->items.begin(), index);
-    return element->as<T>();
+    T value;
+    std::memcpy(&value, this->element<T>(index), sizeof(T));
+    return value;
   }
 
-  std::list<Any> getCollection() { return this->items; }
+  int getType() { return this->type; }
 
- private:
-  int max_length;
-  int type;
-  std::list<Any> items;
-};
+  // os elementos são Object*
+  bool holdsReferences() { return this->references; }
 
-class MultiArray_t {
- public:
-  MultiArray_t(const int &dims, int *dims_sizes);
+  // tamanho em bytes dos elementos
+  size_t bytes() { return this->size * this->element_size; }
+
+  /**
+   * @brief the atype of the elements of an array from its descriptor, like
+   * "[I" or "[[Ljava/lang/String;"
+   *
+   * @param descriptor
+   * @return int
+   */
+  static int getType(const std::string &descriptor);
 
-  ~MultiArray_t();
+  // o atype dos elementos de um array de arrays é referencia
+  static int getElementType(const std::string &descriptor) {
+    return descriptor[1] == '[' ? Reference::kREF_CLASS : getType(descriptor);
+  }
+
+  // bytes de cada elemento de um array do atype
+  static size_t getElementSize(const int &atype);
+
+  // descritor do array de uma dimensão do atype primitivo, como "[I"
+  static std::string getDescriptor(const int &atype);
+
+ private:
+  template <typename T>
+  Types::u1 *element(const int &index) {
+    // as instruções já lançaram a ArrayIndexOutOfBoundsException pela thread
+    if (index < 0 || index >= this->size) {
+      throw Utils::Errors::Exception(Utils::Errors::kINSTRUCTION,
+                                     "array index out of bounds");
+    }
+    if (sizeof(T) != this->element_size) {
+      throw Utils::Errors::Exception(Utils::Errors::kBADCAST,
+                                     "invalid cast in array access");
+    }
+    return this->items + index * this->element_size;
+  }
 
-  Array_t *arrays;
+  int size;
+  int type;
+  size_t element_size;
+  bool references;
+  // elementos começam zerados, que é o valor default de todo tipo em java
+  std::shared_ptr<std::vector<Types::u1>> block;
+  // primeiro elemento do array dentro do bloco
+  Types::u1 *items;
 };
 }  // namespace Utils
 
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "utils/attributes.h"
+#include "utils/symbol_table.h"
 #include "utils/types.h"
 
 namespace Utils {
@@ -91,7 +92,7 @@ class CONSTANT_Class_info : public BaseConstantInfo {
 
   ~CONSTANT_Class_info() = default;
 
-  std::string getValue(const std::vector<cp_info> &constpool) const;
+  const std::string &getValue(const std::vector<cp_info> &constpool) const;
   std::string getGeneralInfo(const std::vector<cp_info> &constpool,
                              const int &delta_tab);
 
@@ -154,7 +155,7 @@ class CONSTANT_String_info : public BaseConstantInfo {
 
   ~CONSTANT_String_info() = default;
 
-  std::string getValue(const std::vector<cp_info> &constpool) const;
+  const std::string &getValue(const std::vector<cp_info> &constpool) const;
   std::string getGeneralInfo(const std::vector<cp_info> &constpool,
                              const int &delta_tab);
 
@@ -238,11 +239,13 @@ class CONSTANT_Utf8_info : public BaseConstantInfo {
 
   ~CONSTANT_Utf8_info() = default;
 
-  std::string getValue() const;
+  const std::string &getValue() const;
   std::string getGeneralInfo(const int &delta_tab);
 
   Types::u2 length;
   std::vector<Types::u1> bytes;
+  // string decodificada e internada pelo Reader
+  mutable Symbol symbol = nullptr;
 };
 
 class CONSTANT_MethodHandle_info : public BaseConstantInfo {
@@ -59,7 +59,10 @@ enum errors {
   kLS,
   kMEMCPY,
   kVIEWER,
-  kFLAG
+  kFLAG,
+  kHEAP,
+  kHEAP_DUMP,
+  kUNCAUGHT
 };
 
 enum vm_errors { kINTERNAL, kOUTOFMEMORY, kSTACKOVERFLOW, kUNKNOWN };
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_UTILS_FLAGS_H_
 #define INCLUDE_UTILS_FLAGS_H_
 
+#include <cstddef>
 #include <string>
 
 struct Options {
@@ -8,6 +9,38 @@ struct Options {
   bool kDEBUG;
   bool kIGNORE;
   bool kJSON;
+  bool kTHREADED;
+  // tamanho em bytes da pilha de cada thread, -Xss
+  size_t kSTACK_SIZE = 1024 * 1024;
+  // tamanho maximo em bytes do heap, -Xmx
+  size_t kHEAP_SIZE = 256 * 1024 * 1024;
+  // tamanho em bytes do nursery, -Xmn
+  size_t kYOUNG_SIZE = 1024 * 1024;
+  // imprime as estatisticas de cada coleta do gc, -verbose:gc
+  bool kVERBOSE_GC;
+  // blocos do heap em huge pages, -XX:+UseLargePages
+  bool kLARGE_PAGES;
+  // threads que marcam o old space numa coleta major,
+  // -XX:ParallelGCThreads=<n>
+  size_t kGC_THREADS = 1;
+  // a marcação do old space é feita em fatias entre as alocações,
+  // -XX:+IncrementalMarking
+  bool kINCREMENTAL_MARKING;
+  // duração maxima de cada fatia da marcação incremental,
+  // -XX:MaxGCPauseMillis=<ms>
+  size_t kMAX_GC_PAUSE_MS = 1;
+  // conta as alocações por classe e por site, -XX:+ProfileAllocations
+  bool kPROFILE_ALLOCATIONS;
+  // heap dump antes do erro de falta de memoria,
+  // -XX:+HeapDumpOnOutOfMemoryError
+  bool kHEAP_DUMP_ON_OOM;
+  // heap dump quando a vm termina, -XX:+HeapDumpAtExit
+  bool kHEAP_DUMP_AT_EXIT;
+  // arquivo dos heap dumps, -XX:HeapDumpPath=<path>
+  std::string kHEAP_DUMP_PATH;
+  // o athrow guarda o stack trace no objeto, desligado com
+  // -XX:-StackTraceInThrowable
+  bool kSTACK_TRACE_IN_THROWABLE = true;
   struct {
     bool kVIEWER;
     bool kINTERPRETER;
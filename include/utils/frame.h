@@ -1,136 +1,184 @@
 #ifndef INCLUDE_UTILS_FRAME_H_
 #define INCLUDE_UTILS_FRAME_H_
 
-#include <stack>
-#include <vector>
-
-#include "utils/constantPool.h"
 #include "utils/errors.h"
-#include "utils/external/any.h"
+#include "utils/slot.h"
 #include "utils/types.h"
 
 namespace Utils {
+struct RuntimeClass_t;
+namespace Attributes {
+class Code_attribute;
+}  // namespace Attributes
+
+/**
+ * @brief header of a method activation. The frame does not own its slots,
+ * the local variables and the operand stack live in the contiguous region of
+ * the thread's JavaStack, the locals right before the header and the operand
+ * stack right after it
+ */
 class Frame {
  public:
-  Frame(const Types::u2 &stack_size, const Types::u2 &localvar_size,
-        const std::vector<ConstantPool::cp_info> &kpool) {
-    this->max_operand_stack_size = stack_size;
+  Frame(RuntimeClass_t *runtime_class, Attributes::Code_attribute *code,
+        Slot *locals, Slot *operands, const Types::u2 &localvar_size,
+        const Types::u2 &stack_size, Frame *caller) {
+    this->runtime_class = runtime_class;
+    this->code = code;
+    this->local_variables = locals;
+    this->operand_stack = operands;
+    this->stack_top = operands;
     this->max_localvar_size = localvar_size;
-    this->local_variables.resize(localvar_size);
-    this->runtime_constant_pool = kpool;
+    this->max_operand_stack_size = stack_size;
+    this->caller = caller;
     this->pc = 0;
   }
 
-  template <typename T>
-  void pushLocalVar(const T &localvar) {
-    if (this->local_variables.size() > this->max_localvar_size) {
-      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
-                                     "Loval Variable Overflow");
-    }
-    this->local_variables[this->last_index++] = localvar;
-    // double e long ocupam 2 slots do vetor de variaveis locais, uma
-    // implementação possivel seria colocar o high e o low em uma, mas eu do
-    // push no valor cheio logo em apenas uma posição
-    if (std::is_same<T, double>::value || std::is_same<T, long>::value) {
-      this->local_variables[this->last_index++] = nullptr;
-    }
-  }
-
   template <typename T>
   void pushLocalVar(const T &localvar, const int &index) {
-    if (this->local_variables.size() > this->max_localvar_size) {
+    if (index + SlotWidth<T>::value > this->max_localvar_size) {
       throw Utils::Errors::Exception(Utils::Errors::kSTACK,
-                                     "Loval Variable Overflow");
+                                     "Local Variable Overflow");
     }
     this->local_variables[index] = localvar;
-    // double e long ocupam 2 slots do vetor de variaveis locais, uma
-    // implementação possivel seria colocar o high e o low em uma, mas eu do
-    // push no valor cheio logo em apenas uma posição
-    if (std::is_same<T, double>::value || std::is_same<T, long>::value) {
-      this->local_variables[index + 1] = nullptr;
+    // double e long ocupam 2 slots do vetor de variaveis locais, o valor fica
+    // no primeiro e o segundo é só um marcador
+    if (SlotWidth<T>::value == 2) {
+      this->local_variables[index + 1] = Slot::top();
     }
   }
 
   template <typename T>
   T getLocalVarValue(const int &index) {
+    this->checkLocalVar(index, SlotWidth<T>::value);
     return this->local_variables[index].as<T>();
   }
 
   template <typename T>
   T *getLocalVarReference(const int &index) {
-    return &this->local_variables[index].as<T>();
+    this->checkLocalVar(index, 1);
+    return this->local_variables[index].reference<T>();
   }
 
   template <typename T>
   void pushOperand(const T &operand) {
-    if (this->operand_stack.size() > this->max_operand_stack_size) {
-      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
-                                     "Stack Frame Overflow");
+    this->checkOverflow(SlotWidth<T>::value);
+    *this->stack_top++ = operand;
+    if (SlotWidth<T>::value == 2) {
+      *this->stack_top++ = Slot::top();
     }
-    this->operand_stack.push(operand);
   }
 
   template <typename T>
   void pushOperand(T *operand) {
-    if (this->operand_stack.size() > this->max_operand_stack_size) {
-      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
-                                     "Stack Frame Overflow");
+    this->checkOverflow(1);
+    *this->stack_top++ = operand;
+  }
+
+  // empilha um valor qualquer, se for long/double ocupa 2 slots
+  void pushOperand(const Slot &operand) {
+    this->checkOverflow(operand.isWide() ? 2 : 1);
+    *this->stack_top++ = operand;
+    if (operand.isWide()) {
+      *this->stack_top++ = Slot::top();
     }
-    this->operand_stack.push(operand);
   }
 
   template <typename T>
   T popOperand() {
-    auto any = this->operand_stack.top();
-    if (std::is_same<T, Any>::value) {
-      this->operand_stack.pop();
-      return any;
-    } else if (!any.is<T>()) {
+    this->checkUnderflow(SlotWidth<T>::value);
+    this->stack_top -= SlotWidth<T>::value;
+    auto &slot = *this->stack_top;
+    if (!slot.is<T>()) {
+      this->stack_top += SlotWidth<T>::value;
       throw Utils::Errors::Exception(Utils::Errors::kBADCAST,
                                      "invalid cast in pop operand");
     }
-    this->operand_stack.pop();
-    return any.as<T>();
+    return slot.as<T>();
   }
 
-  template <typename T>
-  T *popOperandReference() {
-    auto any = this->operand_stack.top();
-    this->operand_stack.pop();
+  // dup, pop e swap trabalham com os slots crus, sem olhar o tipo
+  void pushSlot(const Slot &slot) {
+    this->checkOverflow(1);
+    *this->stack_top++ = slot;
+  }
 
-    if (std::is_same<T, Any>::value) {
-      return any;
-    }
+  Slot popSlot() {
+    this->checkUnderflow(1);
+    return *--this->stack_top;
+  }
 
-    return &any.as<T>();
+  Slot topOperand() {
+    this->checkUnderflow(1);
+    return this->stack_top[-1];
   }
 
-  Any topOperand() { return this->operand_stack.top(); }
+  void cleanOperands() { this->stack_top = this->operand_stack; }
 
-  void cleanOperands() {
-    while (!this->operand_stack.empty()) {
-      this->operand_stack.pop();
-    }
-  }
+  Slot *getLocalVariables() { return this->local_variables; }
+
+  Types::u2 getMaxLocals() { return this->max_localvar_size; }
+
+  // base da pilha de operandos
+  Slot *getOperandStack() { return this->operand_stack; }
+
+  // primeiro slot livre da pilha de operandos
+  Slot *getStackTop() { return this->stack_top; }
+
+  void setStackTop(Slot *top) { this->stack_top = top; }
+
+  Frame *getCaller() { return this->caller; }
+
+  // classe dona do metodo deste frame
+  RuntimeClass_t *getRuntimeClass() { return this->runtime_class; }
+
+  // atributo Code do metodo deste frame, identifica o metodo
+  Attributes::Code_attribute *getCode() { return this->code; }
 
   int pc;
 
  private:
-  int last_index = 0;
-  std::vector<Any> local_variables;
-  std::stack<Any> operand_stack;
-  uint16_t max_operand_stack_size;
-  uint16_t max_localvar_size;
-  std::vector<ConstantPool::cp_info> runtime_constant_pool;
-};
-}  // namespace Utils
+  void checkOverflow(const int &slots) {
+    if (this->stack_top - this->operand_stack + slots >
+        this->max_operand_stack_size) {
+      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
+                                     "Stack Frame Overflow");
+    }
+  }
 
-// std::vector<Any> local_variables = {Any(115), Any("Hello mundo cruel"),
-//                                     Any(651151613.144456), Any(3.14159f)};
+  // sem isso um pop a mais leria o header do frame, que fica logo antes
+  void checkUnderflow(const int &slots) {
+    if (this->stack_top - this->operand_stack < slots) {
+      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
+                                     "Stack Frame Underflow");
+    }
+  }
 
-// std::cout << local_variables[0].as<int>() << "\n";
-// std::cout << local_variables[1].as<const char *>() << "\n";
-// std::cout << local_variables[2].as<double>() << "\n";
-// std::cout << local_variables[3].as<float>() << "\n";
+  void checkLocalVar(const int &index, const int &slots) {
+    if (index < 0 || index + slots > this->max_localvar_size) {
+      throw Utils::Errors::Exception(Utils::Errors::kSTACK,
+                                     "Local Variable Overflow");
+    }
+  }
+
+  RuntimeClass_t *runtime_class;
+  Attributes::Code_attribute *code;
+  Slot *local_variables;
+  Slot *operand_stack;
+  Slot *stack_top;
+  Types::u2 max_localvar_size;
+  Types::u2 max_operand_stack_size;
+  Frame *caller;
+};
+
+// desempilha um valor inteiro, long/double incluso, sem saber o tipo dele
+template <>
+inline Slot Frame::popOperand<Slot>() {
+  this->checkUnderflow(1);
+  if (this->stack_top[-1].isTop()) {
+    --this->stack_top;
+  }
+  return *--this->stack_top;
+}
+}  // namespace Utils
 
 #endif  // INCLUDE_UTILS_FRAME_H_
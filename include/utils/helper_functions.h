@@ -1,6 +1,8 @@
 #ifndef INCLUDE_UTILS_HELPER_FUNCTIONS_H_
 #define INCLUDE_UTILS_HELPER_FUNCTIONS_H_
 
+#include <cmath>
+#include <limits>
 #include <string>
 
 #include "classfile.h"
@@ -11,11 +13,28 @@ Infos::method_info getMethod(const ClassFile *cf,
                              const std::string &method_name);
 
 Attributes::attribute_info getAttribute(
-    const ClassFile *cf, std::vector<Attributes::attribute_info> *attributes,
+    const ClassFile *cf,
+    const std::vector<Attributes::attribute_info> *attributes,
     const std::string &attr_name);
 
 const std::string getClassName(const ClassFile *cf);
 
+// f2i, f2l, d2i e d2l: NaN vira 0 e o que não cabe no inteiro satura, como
+// em java, em vez do comportamento indefinido do static_cast
+template <typename R, typename F>
+inline R toIntegral(const F &value) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  if (value >= static_cast<F>(std::numeric_limits<R>::max())) {
+    return std::numeric_limits<R>::max();
+  }
+  if (value <= static_cast<F>(std::numeric_limits<R>::min())) {
+    return std::numeric_limits<R>::min();
+  }
+  return static_cast<R>(value);
+}
+
 inline void getReference(const ClassFile *cf, const Types::u2 &ref_index,
                          std::string *ref_class_name,
                          std::string *ref_method_name,
@@ -66,6 +85,9 @@ bool methodIs(const Utils::Infos::method_info &method,
 
 bool fieldIs(const Utils::Infos::field_info &field,
              const std::string &access_type);
+
+// quantos slots os argumentos do descritor ocupam, long e double ocupam 2
+int getArgSlots(const std::string &descriptor);
 }  // namespace Utils
 
 #endif  // INCLUDE_UTILS_HELPER_FUNCTIONS_H_
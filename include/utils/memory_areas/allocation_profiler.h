@@ -0,0 +1,77 @@
+#ifndef INCLUDE_UTILS_MEMORY_AREAS_ALLOCATION_PROFILER_H_
+#define INCLUDE_UTILS_MEMORY_AREAS_ALLOCATION_PROFILER_H_
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "utils/attributes.h"
+#include "utils/external/nlohmann_json.hpp"
+#include "utils/frame.h"
+#include "utils/object.h"
+
+namespace MemoryAreas {
+struct ClassRecord;
+
+/**
+ * @brief counts what the bytecode of a thread allocates, with
+ * -XX:+ProfileAllocations. Every new, newarray, anewarray, multianewarray
+ * and ldc of a string is counted by its allocation site: the class of the
+ * object and the method and bytecode offset of the instruction. Counting is
+ * a single hash table access, the name of a method is only looked up the
+ * first time one of its sites is seen, and the counts by class are only
+ * added up in the report
+ */
+class AllocationProfiler {
+ public:
+  struct Count {
+    size_t objects = 0;
+    size_t bytes = 0;
+  };
+
+  /**
+   * @brief counts an object just created by the instruction at frame->pc
+   *
+   * @param obj
+   * @param bytes
+   * @param frame
+   */
+  void record(const Utils::Object *obj, const size_t &bytes,
+              Utils::Frame *frame);
+
+  // soma as contagens de outra thread
+  void merge(const AllocationProfiler &other);
+
+  // relatorio em texto, classes e sites ordenados pelos bytes alocados
+  void report(std::ostream &out) const;
+
+  nlohmann::json toJson() const;
+
+ private:
+  struct Site {
+    bool operator==(const Site &that) const {
+      return this->klass == that.klass && this->code == that.code &&
+             this->pc == that.pc;
+    }
+
+    ClassRecord *klass;
+    const Utils::Attributes::Code_attribute *code;
+    int pc;
+  };
+
+  struct SiteHash {
+    size_t operator()(const Site &site) const {
+      auto hash = std::hash<const void *>()(site.code) ^ site.pc;
+      return hash ^ (std::hash<const void *>()(site.klass) + 0x9e3779b9 +
+                     (hash << 6) + (hash >> 2));
+    }
+  };
+
+  std::unordered_map<Site, Count, SiteHash> sites;
+  // classe, nome e descritor de cada metodo que alocou
+  std::unordered_map<const Utils::Attributes::Code_attribute *, std::string>
+      methods;
+};
+}  // namespace MemoryAreas
+
+#endif  // INCLUDE_UTILS_MEMORY_AREAS_ALLOCATION_PROFILER_H_
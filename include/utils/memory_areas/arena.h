@@ -0,0 +1,71 @@
+#ifndef INCLUDE_UTILS_MEMORY_AREAS_ARENA_H_
+#define INCLUDE_UTILS_MEMORY_AREAS_ARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace MemoryAreas {
+/**
+ * @brief the memory where the heap places its objects. Blocks are reserved
+ * from the system and cut in pages, each page serves a single size class and
+ * its cells are handed out by bumping a pointer. Freed cells go to a free
+ * list of their size class and are reused before the page is bumped again,
+ * so allocating and freeing are O(1) and objects of the same size end up
+ * next to each other
+ */
+class Arena {
+ public:
+  /**
+   * @brief
+   *
+   * @param large_pages asks the system to back the blocks with huge pages,
+   * -XX:+UseLargePages
+   */
+  explicit Arena(const bool &large_pages);
+
+  ~Arena();
+
+  /**
+   * @brief a cell of at least size bytes, aligned to kALIGNMENT. Sizes bigger
+   * than the largest size class get their own allocation
+   *
+   * @param size
+   * @return void*
+   */
+  void *allocate(const size_t &size);
+
+  // size tem que ser o mesmo passado pro allocate
+  void free(void *cell, const size_t &size);
+
+  // bytes reservados do sistema, inclusive os que ainda não foram usados
+  size_t reserved() { return this->reserved_bytes; }
+
+  static const size_t kALIGNMENT = 16;
+
+ private:
+  struct SizeClass {
+    char *top = nullptr;
+    char *end = nullptr;
+    // lista encadeada dentro das proprias celulas liberadas
+    void *free_list = nullptr;
+  };
+
+  static const size_t kSIZE_CLASSES = 32;
+  static const size_t kPAGE_SIZE = 64 * 1024;
+  static const size_t kBLOCK_SIZE = 2 * 1024 * 1024;
+
+  void refill(SizeClass *size_class, const size_t &cell_size);
+
+  char *newBlock();
+
+  SizeClass size_classes[kSIZE_CLASSES];
+  std::vector<void *> blocks;
+  // parte do bloco atual que ainda não virou pagina
+  char *block_top;
+  char *block_end;
+  bool large_pages;
+  size_t reserved_bytes;
+};
+}  // namespace MemoryAreas
+
+#endif  // INCLUDE_UTILS_MEMORY_AREAS_ARENA_H_
@@ -0,0 +1,119 @@
+#ifndef INCLUDE_UTILS_MEMORY_AREAS_CLASS_REGISTRY_H_
+#define INCLUDE_UTILS_MEMORY_AREAS_CLASS_REGISTRY_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "classfile.h"
+#include "utils/class_t.h"
+#include "utils/runtime_class_t.h"
+#include "utils/symbol_table.h"
+
+namespace MemoryAreas {
+/**
+ * @brief everything the vm knows about a class name. A class is loaded when
+ * it has a runtime class and initialized when its static values exist. The
+ * classes that are never loaded, like the ones of the library and the
+ * arrays, still get a record, so every object can point to the record of
+ * its class
+ */
+struct ClassRecord {
+  bool isLoaded() const { return this->runtime_class != nullptr; }
+
+  bool isInitialized() const { return this->statics != nullptr; }
+
+  // se a classe é ancestor ou desce dela
+  bool isSubclassOf(const ClassRecord *ancestor) const {
+    for (auto klass = this; klass; klass = klass->super) {
+      if (klass == ancestor) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Utils::Symbol name = nullptr;
+  // superclasse direta, nullptr pro java/lang/Object e enquanto não se sabe
+  ClassRecord *super = nullptr;
+  // nullptr enquanto a classe não foi carregada
+  Utils::RuntimeClass_t *runtime_class = nullptr;
+  // nullptr enquanto a classe não foi inicializada
+  Utils::Class_t *statics = nullptr;
+};
+
+/**
+ * @brief the classes of the vm, shared by the method area, that loads them,
+ * and by the heap, that initializes them. Every lookup is a single hash
+ * table access keyed by the interned class name
+ */
+class ClassRegistry {
+ public:
+  ClassRegistry() = default;
+
+  ~ClassRegistry();
+
+  // nullptr se o nome nunca foi registrado
+  ClassRecord *find(const std::string &classname) {
+    auto symbol = Utils::SymbolTable::lookup(classname);
+    if (!symbol) {
+      return nullptr;
+    }
+    auto record = this->records.find(symbol);
+    return record == this->records.end() ? nullptr : &record->second;
+  }
+
+  // cria um registro vazio (nem carregado nem inicializado) se preciso
+  ClassRecord *get(const std::string &classname) {
+    auto symbol = Utils::SymbolTable::intern(classname);
+    auto record = &this->records[symbol];
+    if (!record->name) {
+      record->name = symbol;
+      this->linkLibraryClass(record);
+    }
+    return record;
+  }
+
+  /**
+   * @brief registers a classfile as loaded, the registry creates its runtime
+   * class and deletes the classfile when owned is true
+   *
+   * @param cf
+   * @param owned
+   * @return Utils::RuntimeClass_t*
+   */
+  Utils::RuntimeClass_t *add(const ClassFile *cf, const bool &owned);
+
+  template <typename Visitor>
+  void forEach(const Visitor &visit) {
+    for (auto &record : this->records) {
+      visit(&record.second);
+    }
+  }
+
+  // runtime class de um classfile já registrado
+  Utils::RuntimeClass_t *getRuntimeClass(const ClassFile *cf) {
+    auto runtime_class = this->runtime_classes.find(cf);
+    if (runtime_class == this->runtime_classes.end()) {
+      return this->add(cf, false);
+    }
+    return runtime_class->second;
+  }
+
+ private:
+  // as classes da biblioteca não são carregadas, a superclasse das exceções
+  // de java/lang vem de uma tabela
+  void linkLibraryClass(ClassRecord *record);
+
+  // resolve as classes dos catch de cada metodo da classe
+  void linkHandlers(Utils::RuntimeClass_t *runtime_class);
+
+  // indexado pelo symbol do nome da classe
+  std::unordered_map<Utils::Symbol, ClassRecord> records;
+  std::unordered_map<const ClassFile *, Utils::RuntimeClass_t *>
+      runtime_classes;
+  std::vector<const ClassFile *> owned_classfiles;
+};
+}  // namespace MemoryAreas
+
+#endif  // INCLUDE_UTILS_MEMORY_AREAS_CLASS_REGISTRY_H_
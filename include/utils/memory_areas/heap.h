@@ -2,59 +2,333 @@
 #define INCLUDE_UTILS_MEMORY_AREAS_HEAP_H_
 
 #include <algorithm>
-#include <list>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "utils/class_t.h"
 #include "utils/helper_functions.h"
+#include "utils/memory_areas/arena.h"
+#include "utils/memory_areas/class_registry.h"
+#include "utils/memory_areas/hprof_writer.h"
 #include "utils/memory_areas/thread.h"
 #include "utils/object.h"
+#include "utils/slot.h"
 
 namespace MemoryAreas {
+// pausas de até 0.1ms, 1ms, 10ms, 100ms e acima disso
+static const int kPAUSE_BUCKETS = 5;
+
+// estatisticas acumuladas de um tipo de coleta
+struct CollectionStats {
+  void add(const double &pause_ms, const size_t &objects, const size_t &bytes);
+
+  // pausa que não termina uma coleta, como uma fatia da marcação incremental
+  void addPause(const double &pause_ms);
+
+  size_t count = 0;
+  size_t freed_objects = 0;
+  size_t freed_bytes = 0;
+  double total_pause_ms = 0;
+  double max_pause_ms = 0;
+  size_t pauses[kPAUSE_BUCKETS] = {};
+};
+
+// estatisticas do gc, impressas com -verbose:gc
+struct GCStats {
+  CollectionStats minor;
+  CollectionStats major;
+  size_t promoted_objects = 0;
+  size_t promoted_bytes = 0;
+  size_t mark_slices = 0;
+};
+
+// objetos cinzas de uma thread da marcação paralela, as outras roubam daqui
+struct MarkQueue {
+  std::mutex lock;
+  std::deque<Utils::Object *> objects;
+};
+
+/**
+ * @brief the objects of the vm, in two generations. New objects are bump
+ * allocated in the nursery, a minor collection copies the ones that are
+ * still reachable to the old space, in the arena, and throws the rest of the
+ * nursery away at once. The old space is collected by a mark-sweep when it
+ * grows past a threshold, always right after a minor collection, so the
+ * nursery is empty by then. Its mark phase is shared by
+ * -XX:ParallelGCThreads marker threads, each one with its own queue of gray
+ * objects and stealing from the others when it runs out.
+ *
+ * With -XX:+IncrementalMarking the mark phase is split in slices of at most
+ * -XX:MaxGCPauseMillis that run after the minor collections, while the
+ * program keeps going. It marks a snapshot of the heap taken when the
+ * marking starts: the write barriers mark the reference a store is about to
+ * overwrite and the objects created while it runs are born marked. If the
+ * old space fills up before the marking ends, it is finished at once.
+ *
+ * The roots of a minor collection are the frames of the threads, the
+ * string literals still in the nursery and the old objects and static
+ * fields that point to the nursery. The old ones are remembered by the write
+ * barriers of putfield, aastore and putstatic, so the old space is never
+ * scanned. A collection only runs inside newObject and
+ * newInstance, before the new object exists, which is the safepoint: at that
+ * moment every live reference is in a frame slot or in a field. It is also
+ * where the heap dumps asked by SIGUSR1 are written
+ */
 class Heap {
  public:
-  Heap() = default;
+  explicit Heap(ClassRegistry *classes);
 
-  ~Heap() {
-    this->object_refs.remove_if([](Utils::Object *obj) {
-      delete obj;
-      return true;
-    });
-    this->initialized_classes.remove_if([](Utils::Class_t *classref) {
-      delete classref;
-      return true;
-    });
-  }
+  ~Heap();
 
   void addClass(Thread *th, const std::string &name);
 
   Utils::Class_t *getClass(const std::string &name) {
-    return *std::find_if(this->initialized_classes.begin(),
-                         this->initialized_classes.end(),
-                         [&name](const Utils::Class_t *c) {
-                           return !c->class_name.compare(name);
-                         });
+    return this->classes->get(name)->statics;
+  }
+
+  // registro que vai no cabeçalho dos objetos da classe
+  ClassRecord *getRecord(const std::string &name) {
+    return this->classes->get(name);
   }
 
   bool isInitialized(const std::string &name) {
-    return std::find_if(this->initialized_classes.begin(),
-                        this->initialized_classes.end(),
-                        [&name](const Utils::Class_t *c) {
-                          return !c->class_name.compare(name);
-                        }) != this->initialized_classes.end();
+    auto record = this->classes->find(name);
+    return record && record->isInitialized();
   }
 
-  Utils::Object *pushReference(Utils::Object *obj) {
-    this->object_refs.push_back(obj);
+  // as threads cujas pilhas são raizes do gc
+  void addThread(Thread *th) { this->threads.push_back(th); }
 
-    auto it = std::next(this->object_refs.begin(), this->last_obj_index++);
-    return *it;
+  /**
+   * @brief creates an object, in the nursery unless it is too big for it.
+   * The arguments are the same of the Utils::Object constructors
+   *
+   * @return Utils::Object*
+   */
+  template <typename... Args>
+  Utils::Object *newObject(Args &&... args) {
+    auto cell = this->allocate(sizeof(Utils::Object));
+    return this->track(new (cell) Utils::Object(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief creates an object of a class that was laid out, with the instance
+   * fields inline and already holding their default values
+   *
+   * @param runtime_class
+   * @return Utils::Object*
+   */
+  Utils::Object *newInstance(const Utils::RuntimeClass_t *runtime_class);
+
+  /**
+   * @brief the String of the intern pool of the vm with this text, for an
+   * ldc, created the first time it is asked for. The literals are roots of
+   * the gc for as long as the vm runs, which updates the returned slot when
+   * it moves the string, so the slot can be kept in place of the string
+   *
+   * @param th thread that asked for it, the creation goes to its profile
+   * @param value
+   * @return Utils::Object* const*
+   */
+  Utils::Object *const *intern(Thread *th, const std::string &value);
+
+  /**
+   * @brief String.intern: the string of the pool with the same text or, if
+   * there is none, the string itself, which goes into the pool. Unlike the
+   * literals, the pool does not keep these alive, the entry is dropped by
+   * the collection that frees the string, so interning the strings built at
+   * runtime does not grow the heap forever
+   *
+   * @param string
+   * @return Utils::Object*
+   */
+  Utils::Object *intern(Utils::Object *string);
+
+  bool isYoung(const Utils::Object *obj) const {
+    auto address = reinterpret_cast<const char *>(obj);
+    return address >= this->nursery && address < this->nursery_end;
+  }
+
+  /**
+   * @brief called by every store of a reference into an object, with the
+   * value that is being overwritten. Remembers the old objects that start
+   * to point to the nursery
+   *
+   * @param holder
+   * @param old_value
+   * @param value
+   */
+  void writeBarrier(Utils::Object *holder, const Utils::Slot &old_value,
+                    const Utils::Slot &value) {
+    if (this->marking) {
+      this->mark(old_value);
+    }
+    if (value.is<Utils::Object *>() &&
+        this->isYoung(value.as<Utils::Object *>()) && !holder->remembered &&
+        !this->isYoung(holder)) {
+      holder->remembered = true;
+      this->remembered.push_back(holder);
+    }
+  }
+
+  // o mesmo, pro putstatic
+  void writeBarrier(Utils::Class_t *statics, const Utils::Slot &old_value,
+                    const Utils::Slot &value) {
+    if (this->marking) {
+      this->mark(old_value);
+    }
+    if (value.is<Utils::Object *>() &&
+        this->isYoung(value.as<Utils::Object *>()) && !statics->remembered) {
+      statics->remembered = true;
+      this->remembered_statics.push_back(statics);
+    }
+  }
+
+  // coleta minor seguida de uma major
+  void collect();
+
+  // bytes ocupados pelos objetos do old space
+  size_t size() { return this->allocated; }
+
+  const GCStats &getStats() { return this->stats; }
+
+  // bytes do objeto, aproximado: conta o conteudo de strings e arrays
+  static size_t sizeOf(Utils::Object *obj);
+
+  /**
+   * @brief writes every object of the heap, the classes with their static
+   * fields and the frames of the threads, as roots, to an HPROF file, in
+   * -XX:HeapDumpPath or in .out/<classname>_heap.hprof. The dumps after the
+   * first one get a sequence number appended to the name
+   */
+  void dump();
+
+  // visit recebe cada objeto do nursery e do old space
+  template <typename Visitor>
+  void forEachObject(const Visitor &visit) {
+    for (auto cell = this->nursery; cell < this->nursery_top;) {
+      auto obj = reinterpret_cast<Utils::Object *>(cell);
+      cell += Heap::alignCell(Heap::cellSize(obj));
+      visit(obj);
+    }
+    for (auto obj : this->object_refs) {
+      visit(obj);
+    }
   }
-  std::list<Utils::Class_t *> initialized_classes;
 
  private:
-  int last_obj_index = 0;
-  std::list<Utils::Object *> object_refs;
+  void *allocate(const size_t &size);
+
+  Utils::Object *track(Utils::Object *obj);
+
+  void collectYoung();
+
+  // termina a marcação incremental, se ela começou, e faz o sweep
+  void collectOld();
+
+  void startMarking();
+
+  // uma fatia da marcação incremental, coleta quando ela acaba
+  void stepMarking();
+
+  // major se o old space passou do limite, erro se nem assim coube
+  void checkOldSpace(const size_t &incoming);
+
+  Utils::Object *evacuate(Utils::Object *obj);
+
+  void evacuate(Utils::Slot *slot);
+
+  void evacuate(Any *value);
+
+  void scan(Utils::Object *obj);
+
+  void destroy(Utils::Object *obj) {
+    auto size = Heap::cellSize(obj);
+    obj->~Object();
+    this->arena.free(obj, size);
+  }
+
+  void mark(Utils::Object *obj);
+
+  void mark(const Utils::Slot &slot);
+
+  void markRoots();
+
+  void trace();
+
+  void traceParallel();
+
+  void markWorker(std::vector<MarkQueue> *queues, const size_t &id,
+                  std::atomic<size_t> *pending);
+
+  size_t sweep();
+
+  void printSummary();
+
+  // escreve os registros do dump, retorna quantos objetos foram escritos
+  size_t writeDump(HprofWriter *hprof);
+
+  static size_t cellSize(const Utils::Object *obj) {
+    return sizeof(Utils::Object) + obj->field_count * sizeof(Utils::Slot);
+  }
+
+  static size_t alignCell(const size_t &size) {
+    return (size + Arena::kALIGNMENT - 1) / Arena::kALIGNMENT *
+           Arena::kALIGNMENT;
+  }
+
+  ClassRegistry *classes;
+  std::vector<Thread *> threads;
+  Arena arena;
+  // todos os objetos do old space, é por aqui que o sweep os percorre
+  std::vector<Utils::Object *> object_refs;
+  // objetos marcados que ainda não tiveram as referencias percorridas. A
+  // marcação incremental os mantém entre uma fatia e outra
+  std::vector<Utils::Object *> gray;
+  // copias da minor que ainda não tiveram as referencias percorridas
+  std::vector<Utils::Object *> copied;
+  Utils::Types::u4 epoch;
+  // a marcação incremental começou e ainda não acabou
+  bool marking;
+  size_t allocated;
+  // a proxima coleta major acontece quando allocated passar disso
+  size_t next_gc;
+
+  char *nursery;
+  char *nursery_top;
+  char *nursery_end;
+  // bytes dos objetos do nursery, contando o conteudo de strings e arrays
+  size_t young_allocated;
+  size_t young_limit;
+  // objetos velhos e fields estáticos que apontam pro nursery
+  std::vector<Utils::Object *> remembered;
+  std::vector<Utils::Class_t *> remembered_statics;
+  struct InternedString {
+    Utils::Object *string;
+    // veio de um ldc e é raiz, as do String.intern não seguram a string
+    bool literal;
+  };
+
+  // remove do pool as strings do String.intern que a coleta vai liberar
+  void dropDeadInterned();
+
+  // strings do ldc e do String.intern, pelo texto
+  std::unordered_map<std::string, InternedString> interned;
+  // slots dos literais do pool que ainda estão no nursery
+  std::vector<Utils::Object **> young_interned;
+  // textos das entradas do String.intern cujas strings estão no nursery
+  std::vector<const std::string *> young_weak_interned;
+  GCStats stats;
+  // heap dumps já escritos
+  size_t dumps;
+  // -XX:+HeapDumpOnOutOfMemoryError só escreve o primeiro
+  bool dumped_on_oom;
 };
 }  // namespace MemoryAreas
 
@@ -0,0 +1,113 @@
+#ifndef INCLUDE_UTILS_MEMORY_AREAS_HPROF_WRITER_H_
+#define INCLUDE_UTILS_MEMORY_AREAS_HPROF_WRITER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace MemoryAreas {
+// registros do arquivo
+enum hprof_tags {
+  kHPROF_UTF8 = 0x01,
+  kHPROF_LOAD_CLASS = 0x02,
+  kHPROF_FRAME = 0x04,
+  kHPROF_TRACE = 0x05,
+  kHPROF_HEAP_DUMP_SEGMENT = 0x1C,
+  kHPROF_HEAP_DUMP_END = 0x2C
+};
+
+// sub registros de um HEAP DUMP SEGMENT
+enum hprof_heap_tags {
+  kHPROF_ROOT_UNKNOWN = 0xFF,
+  kHPROF_ROOT_JAVA_FRAME = 0x03,
+  kHPROF_ROOT_STICKY_CLASS = 0x05,
+  kHPROF_CLASS_DUMP = 0x20,
+  kHPROF_INSTANCE_DUMP = 0x21,
+  kHPROF_OBJ_ARRAY_DUMP = 0x22,
+  kHPROF_PRIM_ARRAY_DUMP = 0x23
+};
+
+// os tipos primitivos tem os mesmos valores do atype do newarray
+enum hprof_types { kHPROF_OBJECT = 2 };
+
+/**
+ * @brief writes a heap dump in the HPROF binary format of the JDK, version
+ * 1.0.2, with 8 byte identifiers. Every record goes straight to the file:
+ * the length of a heap dump segment is only known at its end, so it is
+ * written as zero and patched when the segment is closed. The identifier of
+ * a string is the address of the std::string that holds it, which has to
+ * live until the end of the dump
+ */
+class HprofWriter {
+ public:
+  // cria o arquivo e escreve o cabeçalho
+  explicit HprofWriter(const std::string &path);
+
+  // id do registro UTF8 do texto, que só é escrito da primeira vez
+  Utils::Types::u8 writeString(const std::string *str);
+
+  void writeLoadClass(const Utils::Types::u4 &serial, const void *klass,
+                      const std::string *name);
+
+  /**
+   * @brief a frame of a stack trace
+   *
+   * @param frame identifier of the frame
+   * @param method_name
+   * @param descriptor
+   * @param class_serial serial of the LOAD CLASS of the owner of the method
+   */
+  void writeFrame(const void *frame, const std::string *method_name,
+                  const std::string *descriptor,
+                  const Utils::Types::u4 &class_serial);
+
+  void writeTrace(const Utils::Types::u4 &serial,
+                  const Utils::Types::u4 &thread_serial,
+                  const std::vector<const void *> &frames);
+
+  // começa um sub registro, abrindo um segmento do heap dump se preciso
+  void beginSubRecord(const Utils::Types::u1 &tag);
+
+  // fecha o ultimo segmento e escreve o HEAP DUMP END
+  void finish();
+
+  void writeU1(const Utils::Types::u1 &value) { this->out.put(value); }
+
+  void writeU2(const Utils::Types::u2 &value) { this->writeBytes(value, 2); }
+
+  void writeU4(const Utils::Types::u4 &value) { this->writeBytes(value, 4); }
+
+  void writeU8(const Utils::Types::u8 &value) { this->writeBytes(value, 8); }
+
+  void writeId(const void *id) {
+    this->writeU8(reinterpret_cast<uintptr_t>(id));
+  }
+
+  // bytes escritos até agora
+  size_t size() { return this->out.tellp(); }
+
+ private:
+  // big endian, como todo o arquivo
+  void writeBytes(const Utils::Types::u8 &value, const int &count) {
+    for (auto shift = (count - 1) * 8; shift >= 0; shift -= 8) {
+      this->out.put(static_cast<char>(value >> shift));
+    }
+  }
+
+  void beginRecord(const Utils::Types::u1 &tag,
+                   const Utils::Types::u4 &length);
+
+  void closeSegment();
+
+  std::ofstream out;
+  std::unordered_set<const std::string *> strings;
+  // posição do cabeçalho do segmento aberto, -1 se não tem
+  std::streamoff segment = -1;
+};
+}  // namespace MemoryAreas
+
+#endif  // INCLUDE_UTILS_MEMORY_AREAS_HPROF_WRITER_H_
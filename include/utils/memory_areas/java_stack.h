@@ -1,29 +1,46 @@
 #ifndef INCLUDE_UTILS_MEMORY_AREAS_JVM_STACK_H_
 #define INCLUDE_UTILS_MEMORY_AREAS_JVM_STACK_H_
 
-#include <stack>
+#include <memory>
 
 #include "utils/frame.h"
 
 namespace MemoryAreas {
+/**
+ * @brief the frames of a thread. Every frame is bump allocated in a single
+ * contiguous region of slots: the local variables, the frame header and then
+ * the operand stack. The locals of a new frame start where the arguments are
+ * in the caller's operand stack, so they are passed without any copy
+ */
 class JavaStack {
  public:
-  ~JavaStack() {
-    while (!this->frames.empty()) {
-      this->frames.pop();
-    }
-  }
+  explicit JavaStack(const size_t &size_in_bytes);
 
-  void push(Utils::Frame *frame) { this->frames.push(frame); }
+  /**
+   * @brief creates a frame on top of the stack
+   *
+   * @param runtime_class class of the method that will run in the frame
+   * @param code Code attribute of the method, with its max_locals and
+   * max_stack
+   * @param arg_slots how many slots in the top of the caller's operand stack
+   * are arguments of the new frame, they become its first local variables
+   * @return Utils::Frame*
+   */
+  Utils::Frame *push(Utils::RuntimeClass_t *runtime_class,
+                     Utils::Attributes::Code_attribute *code,
+                     const int &arg_slots);
 
-  void pop() { this->frames.pop(); }
+  void pop();
 
-  Utils::Frame *top() { return this->frames.top(); }
+  Utils::Frame *top() { return this->top_frame; }
 
-  size_t size() { return this->frames.size(); }
+  size_t size() { return this->depth; }
 
  private:
-  std::stack<Utils::Frame *> frames;
+  std::unique_ptr<Utils::Slot[]> region;
+  size_t capacity;
+  Utils::Frame *top_frame;
+  size_t depth;
 };
 }  // namespace MemoryAreas
 
@@ -1,41 +1,42 @@
 #ifndef INCLUDE_UTILS_MEMORY_AREAS_METHOD_AREA_H_
 #define INCLUDE_UTILS_MEMORY_AREAS_METHOD_AREA_H_
 
-#include <list>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "classfile.h"
+#include "instructions/threaded_engine.h"
 #include "utils/helper_functions.h"
 #include "utils/infos.h"
+#include "utils/memory_areas/class_registry.h"
+#include "utils/runtime_class_t.h"
 
 namespace MemoryAreas {
 class MethodArea {
  public:
-  MethodArea(const ClassFile *cf) { this->update(cf); }
+  MethodArea(ClassRegistry *classes, const ClassFile *cf) {
+    this->classes = classes;
+    this->update(cf);
+  }
 
   ~MethodArea() {
-    this->loaded.remove_if([](const ClassFile *cf) {
-      delete cf;
-      return true;
-    });
+    for (auto &entry : this->decoded) {
+      delete entry.second;
+    }
   }
 
   void update(const ClassFile *cf) {
-    this->runtime_classfile = cf;
-    this->runtime_constant_pool = cf->constant_pool;
-    this->methods = cf->methods;
-    this->fields = cf->fields;
+    this->runtime_class = this->getRuntimeClass(cf);
+  }
+
+  Utils::RuntimeClass_t *getRuntimeClass(const ClassFile *cf) {
+    return this->classes->getRuntimeClass(cf);
   }
 
   bool isLoaded(const std::string &classname) {
-    auto already_pushed =
-        std::find_if(this->loaded.begin(), this->loaded.end(),
-                     [&classname](const ClassFile *classfile) {
-                       auto actual_name = Utils::getClassName(classfile);
-                       return !classname.compare(actual_name);
-                     });
-    return already_pushed != this->loaded.end();
+    auto record = this->classes->find(classname);
+    return record && record->isLoaded();
   }
 
   const ClassFile *getClass(const std::string &classname);
@@ -46,22 +47,70 @@ class MethodArea {
 
   const ClassFile *loadClass(const std::string &classname);
 
-  Utils::Infos::method_info getMethod(const std::string &method_name,
-                                      const std::string &descriptor);
+  const Utils::Infos::method_info &getMethod(const std::string &method_name,
+                                             const std::string &descriptor) {
+    return this->getMethod(this->runtime_class, method_name, descriptor);
+  }
+
+  const Utils::Infos::method_info &getMethod(
+      const Utils::RuntimeClass_t *owner, const std::string &method_name,
+      const std::string &descriptor);
+
+  const Utils::Infos::field_info &getField(const std::string &field_name) {
+    return this->getField(this->runtime_class, field_name);
+  }
 
-  Utils::Infos::field_info getField(const std::string &field_name);
+  const Utils::Infos::field_info &getField(const Utils::RuntimeClass_t *owner,
+                                           const std::string &field_name);
 
-  std::vector<Utils::ConstantPool::cp_info> runtime_constant_pool;
-  const ClassFile *runtime_classfile;
-  std::vector<Utils::Infos::field_info> fields;
+  /**
+   * @brief resolves the method of a constant pool entry: loads the class that
+   * declares it and caches its runtime class and Code attribute in the entry
+   *
+   * @param ref
+   */
+  void linkMethod(Utils::MethodRef_t *ref);
+
+  /**
+   * @brief resolves the method of an interface entry for the class of the
+   * objectref: the closest implementation in the class or its superclasses,
+   * or the default method of the interface if none of them implements it.
+   * The entry caches the result for that class
+   *
+   * @param ref
+   * @param receiver class of the objectref
+   */
+  void linkInterfaceMethod(Utils::MethodRef_t *ref, ClassRecord *receiver);
+
+  /**
+   * @brief resolves the field of a constant pool entry to its slot. Instance
+   * fields may be inherited and are resolved to their slot in the objects,
+   * static fields to their slot in the statics of the class that declares
+   * them
+   *
+   * @param ref
+   */
+  void linkField(Utils::FieldRef_t *ref);
+
+  /**
+   * @brief lays out the instance and static fields of a class, loading and
+   * laying out its superclasses first
+   *
+   * @param runtime_class
+   */
+  void layoutFields(Utils::RuntimeClass_t *runtime_class);
+
+  Instructions::DecodedMethod *getDecodedMethod(
+      Utils::Attributes::Code_attribute *code_attr);
+
+  // classe do metodo que está executando
+  Utils::RuntimeClass_t *runtime_class;
 
  private:
-  const ClassFile *loadClass(const ClassFile *cf) {
-    this->loaded.push_back(cf);
-    return cf;
-  }
-  std::list<const ClassFile *> loaded;
-  std::vector<Utils::Infos::method_info> methods;
+  ClassRegistry *classes;
+  // cada método é decodificado uma vez só, na primeira chamada
+  std::map<Utils::Attributes::Code_attribute *, Instructions::DecodedMethod *>
+      decoded;
 };
 }  // namespace MemoryAreas
 
@@ -1,18 +1,26 @@
 #ifndef INCLUDE_UTILS_MEMORY_AREAS_THREAD_H_
 #define INCLUDE_UTILS_MEMORY_AREAS_THREAD_H_
 
+#include "utils/attributes.h"
+#include "utils/flags.h"
+#include "utils/memory_areas/allocation_profiler.h"
 #include "utils/memory_areas/java_stack.h"
+#include "utils/object.h"
+#include "utils/runtime_class_t.h"
 
 namespace MemoryAreas {
 class Heap;
 class MethodArea;
 class Thread {
  public:
-  Thread(MethodArea *method_area, Heap *heap, const ClassFile *cf) {
+  Thread(MethodArea *method_area, Heap *heap, const ClassFile *cf)
+      : jvm_stack(Utils::Flags::options.kSTACK_SIZE) {
     this->method_area = method_area;
     this->heap = heap;
     this->current_class = cf;
     this->current_frame = nullptr;
+    this->pending_exception = nullptr;
+    this->native_stack_limit = getNativeStackLimit();
   }
 
   void executeMethod(const std::string &method_name,
@@ -22,26 +30,103 @@ class Thread {
   void changeContext(const std::string &classname, const std::string &method,
                      const std::string &arguments, const bool &popObjectRef);
 
-  void storeArguments(const std::string &args, Utils::Frame *new_frame,
-                      const bool &popObjectRef);
+  /**
+   * @brief runs the method of an already linked constant pool entry, the
+   * owner class and the Code attribute come from the entry so nothing is
+   * looked up by name
+   *
+   * @param ref
+   * @param popObjectRef if the objectref is also passed as argument
+   */
+  void changeContext(Utils::MethodRef_t *ref, const bool &popObjectRef);
+
+  // frame no topo da pilha da thread, o gc percorre a pilha a partir dele
+  Utils::Frame *getTopFrame() { return this->jvm_stack.top(); }
+
+  // depois de cada objeto criado pelo bytecode, com -XX:+ProfileAllocations
+  void profileAllocation(Utils::Object *obj);
+
+  const AllocationProfiler &getProfiler() { return this->profiler; }
+
+  /**
+   * @brief raises a Java exception in the thread. Nothing is unwound here:
+   * the execution loop checks the pending exception after each instruction,
+   * jumps to the handler of the current method if there is one and otherwise
+   * returns to the caller, which does the same after the invoke. The first
+   * time the object is thrown the frames of the stack are copied to it,
+   * unless -XX:-StackTraceInThrowable
+   *
+   * @param obj
+   */
+  void throwException(Utils::Object *obj);
+
+  /**
+   * @brief creates and throws an exception that the vm raises itself, like
+   * the NullPointerException of a getfield. It is pending like the ones of
+   * athrow, so the instruction has to return right after
+   *
+   * @param classname as in the constant pool, like java/lang/Error
+   * @param message
+   */
+  void throwNewException(const std::string &classname,
+                         const std::string &message = "");
+
+  /**
+   * @brief the array of an xaload/xastore, checking the null reference and
+   * the index
+   *
+   * @param arrayref
+   * @param index
+   * @return Utils::Array_t* nullptr if an exception was thrown
+   */
+  Utils::Array_t *getArray(Utils::Object *arrayref, const int &index);
 
   template <typename T>
   void pushReturnValue(const T &val) {
-    auto curr_frame = this->jvm_stack.top();
-    this->jvm_stack.pop();
-    auto caller_frame = this->jvm_stack.top();
-    caller_frame->pushOperand<T>(val);
-    this->jvm_stack.push(curr_frame);
+    this->jvm_stack.top()->getCaller()->pushOperand<T>(val);
   }
 
   MethodArea *method_area;
   Heap *heap;
   Utils::Frame *current_frame;
   const ClassFile *current_class;
+  // exceção lançada que ainda não achou um handler, também é raiz do gc
+  Utils::Object *pending_exception;
 
  private:
+  void runMethod(const std::string &method_name,
+                 Utils::Attributes::Code_attribute *code_attr,
+                 const int &arg_slots);
+
+  void runBytecode(Utils::Attributes::Code_attribute *code_attr);
+
+  void runDecoded(Utils::Attributes::Code_attribute *code_attr);
+
+  // retorna o handler_pc que trata a exceção ou -1 se não houver nenhum
+  int findExceptionHandler(Utils::Attributes::Code_attribute *code_attr,
+                           Utils::Object *obj);
+
+  /**
+   * @brief looks for a handler of the pending exception at the pc of the
+   * current frame. When one is found the exception stops being pending and is
+   * pushed on the cleaned operand stack
+   *
+   * @param code_attr
+   * @return int the handler_pc or -1 if the exception leaves the method
+   */
+  int catchPendingException(Utils::Attributes::Code_attribute *code_attr);
+
+  // cada chamada java também é recursão em C++ (runMethod, o loop do engine,
+  // o invoke e o changeContext), o limite é checado antes de cada frame pra
+  // que a pilha nativa não estoure com um segfault
+  static const char *getNativeStackLimit();
+
   JavaStack jvm_stack;
+  // abaixo disso um novo frame pode estourar a pilha nativa, nullptr se a
+  // plataforma não informa a pilha
+  const char *native_stack_limit;
   std::string current_method;
+  AllocationProfiler profiler;
 };
 }  // namespace MemoryAreas
 
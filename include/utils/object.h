@@ -1,54 +1,115 @@
 #ifndef INCLUDE_UTILS_OBJECT_H_
 #define INCLUDE_UTILS_OBJECT_H_
 
-#include <map>
+#include <atomic>
+#include <string>
+#include <utility>
 
 #include "utils/array_t.h"
 #include "utils/external/any.h"
-#include "utils/field_t.h"
 #include "utils/reference_kind.h"
+#include "utils/slot.h"
+#include "utils/string_builder_t.h"
+#include "utils/types.h"
+
+namespace MemoryAreas {
+struct ClassRecord;
+}  // namespace MemoryAreas
 
 // java/lang/String
 // java/lang/Object
 // [...
 namespace Utils {
+/**
+ * @brief an object of the heap. The header is just the record of its class,
+ * where the name and the runtime class are, the identity hash and the gc
+ * mark, which the marker threads of the gc set with a compare and swap. The
+ * instance fields are not part of the struct, the heap places
+ * field_count slots right after it, in the order given by the field layout
+ * of the class
+ */
 struct Object {
-  // Object() = default;
+  explicit Object(MemoryAreas::ClassRecord *klass) { this->klass = klass; }
 
-  Object(const std::string &classname) { this->class_name = classname; }
+  // o gc move os objetos do nursery pro old space
+  Object(Object &&that)
+      : klass(that.klass),
+        hash(that.hash),
+        gc_epoch(that.gc_epoch.load(std::memory_order_relaxed)),
+        data(std::move(that.data)),
+        field_count(that.field_count) {}
 
-  template <typename T>
-  Object(T v, const std::string &classname) {
-    this->class_name = classname;
-    this->data = v;
-  }
+  Object(const Object &) = delete;
 
   template <typename T>
-  Object(T v, int ref_type, const std::string &classname) {
-    this->class_name = classname;
+  Object(T v, MemoryAreas::ClassRecord *klass) {
+    this->klass = klass;
     this->data = v;
-    this->type = ref_type;
   }
 
   ~Object() {
     if (this->data.is<Array_t *>()) {
       delete this->data.as<Array_t *>();
-    } else if (this->data.is<MultiArray_t *>()) {
-      delete this->data.as<MultiArray_t *>();
     }
-    for (auto it = this->fields.begin(); it != this->fields.end(); ++it) {
-      delete it->second;
+  }
+
+  Slot *getFields() { return reinterpret_cast<Slot *>(this + 1); }
+
+  // visit recebe cada objeto apontado pelos fields, pelos elementos do array
+  // ou pelo data, inclusive nullptr
+  template <typename Visitor>
+  void forEachReference(const Visitor &visit) {
+    auto fields = this->getFields();
+    for (auto i = 0; i < this->field_count; ++i) {
+      if (fields[i].is<Object *>()) {
+        visit(fields[i].as<Object *>());
+      }
+    }
+    if (this->data.is<Array_t *>()) {
+      auto array = this->data.as<Array_t *>();
+      for (auto i = 0; array->holdsReferences() && i < array->length(); ++i) {
+        visit(array->get<Object *>(i));
+      }
+    } else if (this->data.is<Object *>()) {
+      visit(this->data.as<Object *>());
+    } else if (this->data.is<StringBuilder_t>()) {
+      visit(this->data.as<StringBuilder_t>().shared);
     }
   }
 
-  void addField(const std::string &field_name, Field_t *f) {
-    this->fields[field_name] = f;
+  // true só pra quem marcou o objeto na epoca, mesmo com varias threads
+  bool tryMark(const Types::u4 &epoch) {
+    auto seen = this->gc_epoch.load(std::memory_order_relaxed);
+    return seen != epoch &&
+           this->gc_epoch.compare_exchange_strong(seen, epoch,
+                                                  std::memory_order_relaxed);
+  }
+
+  // sorteado na primeira vez que é pedido e fixo a partir dai
+  Types::u4 identityHash() {
+    static Types::u4 seed = 0x9e3779b9;
+    while (!this->hash) {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      this->hash = seed;
+    }
+    return this->hash;
   }
 
-  std::string class_name;
-  int type;
+  union {
+    MemoryAreas::ClassRecord *klass;
+    // só num objeto do nursery que já foi copiado: onde está a copia
+    Object *forwardee;
+  };
+  Types::u4 hash = 0;
+  // coleta em que o objeto foi marcado como vivo pela ultima vez
+  std::atomic<Types::u4> gc_epoch{0};
   Any data;
-  std::map<std::string, Field_t *> fields;
+  int field_count = 0;
+  bool forwarded = false;
+  // está no remembered set do heap
+  bool remembered = false;
 };
 }  // namespace Utils
 
@@ -0,0 +1,327 @@
+#ifndef INCLUDE_UTILS_RUNTIME_CLASS_T_H_
+#define INCLUDE_UTILS_RUNTIME_CLASS_T_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "classfile.h"
+#include "utils/attributes.h"
+#include "utils/errors.h"
+#include "utils/helper_functions.h"
+#include "utils/slot.h"
+#include "utils/symbol_table.h"
+
+namespace MemoryAreas {
+struct ClassRecord;
+}  // namespace MemoryAreas
+
+namespace Utils {
+struct Class_t;
+struct RuntimeClass_t;
+
+// o que a instrução de invoke faz com o metodo resolvido
+enum invoke_kinds {
+  kINVOKE_UNRESOLVED,
+  // metodo com bytecode, executado em um novo frame
+  kINVOKE_JAVA,
+  kINVOKE_PRINT,
+  kINVOKE_PRINTLN,
+  kINVOKE_APPEND,
+  // StringBuilder.toString, que passa o buffer pra uma String nova
+  kINVOKE_TO_STRING,
+  // os outros toString e os <init> de String, StringBuilder e Exception
+  kINVOKE_IGNORED,
+  // printStackTrace e getStackTrace de um Throwable
+  kINVOKE_PRINT_STACK_TRACE,
+  kINVOKE_GET_STACK_TRACE,
+  // String.intern, pelo pool do heap
+  kINVOKE_INTERN,
+  // System.nanoTime e System.currentTimeMillis
+  kINVOKE_NANO_TIME,
+  kINVOKE_CURRENT_TIME_MILLIS
+};
+
+/**
+ * @brief a CONSTANT_Methodref after resolution. The names are decoded once
+ * and, after the first execution, owner and code point straight to the
+ * method that has to run
+ */
+struct MethodRef_t {
+  std::string class_name;
+  std::string method_name;
+  std::string descriptor;
+  int kind = kINVOKE_UNRESOLVED;
+  RuntimeClass_t *owner = nullptr;
+  // nullptr se o metodo não tem o atributo Code (abstract, native)
+  Attributes::Code_attribute *code = nullptr;
+  // slots dos argumentos, sem contar o objectref
+  int arg_slots = 0;
+  // invokestatic já inicializou a classe dona
+  bool initialized = false;
+  // classe do objectref do ultimo invokeinterface, owner e code são os do
+  // metodo que ela implementa
+  MemoryAreas::ClassRecord *receiver = nullptr;
+};
+
+struct FieldRef_t {
+  std::string class_name;
+  std::string field_name;
+  std::string descriptor;
+  bool resolved = false;
+  bool is_static = false;
+  // posição do field nos slots do objeto ou, se for estático, da classe
+  int slot = -1;
+  // getstatic de java/lang/System.out é ignorado
+  bool ignored = false;
+  // valores dos fields estáticos da classe dona
+  Class_t *statics = nullptr;
+};
+
+struct ClassRef_t {
+  std::string name;
+  bool initialized = false;
+  // nullptr pras classes da biblioteca, que não tem fields
+  RuntimeClass_t *runtime_class = nullptr;
+  // registro da classe, pro cabeçalho dos objetos
+  MemoryAreas::ClassRecord *record = nullptr;
+};
+
+struct ExceptionHandler {
+  int handler_pc;
+  // nullptr no catch_type 0, que pega qualquer exceção (finally)
+  MemoryAreas::ClassRecord *catch_class;
+};
+
+/**
+ * @brief the handlers that cover the pcs in [start_pc, end_pc). The ranges
+ * of a method do not overlap and every handler keeps the order of the
+ * exception_table, so the first one that matches is the one the class file
+ * asks for
+ */
+struct HandlerRange {
+  int start_pc;
+  int end_pc;
+  std::vector<ExceptionHandler> handlers;
+};
+
+// ordenada pelo start_pc, pra busca binária
+typedef std::vector<HandlerRange> HandlerTable;
+
+/**
+ * @brief runtime view of a loaded class. It is created once per ClassFile by
+ * the MethodArea and only refers to the classfile data, so switching the
+ * current class is just changing a pointer. It also keeps hash indexes of
+ * the declared methods and fields, the resolved constant pool cache, indexed
+ * the same way as the constant pool, and the layout of the instance fields:
+ * every field, including the inherited ones, has a fixed slot in the objects
+ * of the class and the fields of a superclass come first, so a slot means
+ * the same in the objects of every subclass. The static fields are laid out
+ * apart, in the slots of the Class_t of the class
+ */
+struct RuntimeClass_t {
+  explicit RuntimeClass_t(const ClassFile *cf)
+      : classfile(cf),
+        constant_pool(cf->constant_pool),
+        methods(cf->methods),
+        fields(cf->fields),
+        name(*SymbolTable::intern(getClassName(cf))),
+        method_refs(cf->constant_pool.size()),
+        field_refs(cf->constant_pool.size()),
+        class_refs(cf->constant_pool.size()),
+        string_refs(cf->constant_pool.size()) {
+    for (auto &method : this->methods) {
+      this->method_index.emplace(
+          std::make_pair(this->getSymbol(method.name_index),
+                         this->getSymbol(method.descriptor_index)),
+          &method);
+    }
+    for (auto &field : this->fields) {
+      this->field_index.emplace(this->getSymbol(field.name_index), &field);
+    }
+  }
+
+  // nullptr se a classe não declara o metodo
+  const Infos::method_info *findMethod(const Symbol &method_name,
+                                       const Symbol &descriptor) const {
+    auto method =
+        this->method_index.find(std::make_pair(method_name, descriptor));
+    return method == this->method_index.end() ? nullptr : method->second;
+  }
+
+  const Infos::method_info *findMethod(const std::string &method_name,
+                                       const std::string &descriptor) const {
+    // nome que nunca foi internado não pode estar em nenhuma classe
+    auto name = SymbolTable::lookup(method_name);
+    auto desc = SymbolTable::lookup(descriptor);
+    return name && desc ? this->findMethod(name, desc) : nullptr;
+  }
+
+  // nullptr se nenhum metodo da classe executa esse bytecode
+  const Infos::method_info *findMethod(
+      const Attributes::Code_attribute *code) const {
+    for (auto &method : this->methods) {
+      try {
+        auto attribute =
+            getAttribute(this->classfile, &method.attributes, "Code");
+        if (attribute.getClass<Attributes::Code_attribute>() == code) {
+          return &method;
+        }
+      } catch (const Errors::Exception &e) {
+        // metodos abstratos e nativos não tem bytecode
+      }
+    }
+    return nullptr;
+  }
+
+  // nome ou descritor de um metodo ou field, internado no constant pool
+  const std::string *getUtf8(const Types::u2 &index) const {
+    return this->getSymbol(index);
+  }
+
+  const Infos::field_info *findField(const Symbol &field_name) const {
+    auto field = this->field_index.find(field_name);
+    return field == this->field_index.end() ? nullptr : field->second;
+  }
+
+  const Infos::field_info *findField(const std::string &field_name) const {
+    auto name = SymbolTable::lookup(field_name);
+    return name ? this->findField(name) : nullptr;
+  }
+
+  // -1 se nem a classe nem as superclasses tem o field de instancia
+  int findFieldSlot(const std::string &field_name) const {
+    auto name = SymbolTable::lookup(field_name);
+    auto slot = name ? this->field_slots.find(name) : this->field_slots.end();
+    return slot == this->field_slots.end() ? -1 : slot->second;
+  }
+
+  // -1 se a classe não declara o field estático
+  int findStaticSlot(const std::string &field_name) const {
+    auto name = SymbolTable::lookup(field_name);
+    auto slot =
+        name ? this->static_slots.find(name) : this->static_slots.end();
+    return slot == this->static_slots.end() ? -1 : slot->second;
+  }
+
+  /**
+   * @brief places the instance fields declared by the class after the ones
+   * of the superclass, which has to be laid out already, and gives a slot to
+   * each static field
+   *
+   * @param super nullptr when the superclass is not loaded by the vm
+   */
+  void layoutFields(const RuntimeClass_t *super) {
+    if (super) {
+      this->field_slots = super->field_slots;
+      this->field_defaults = super->field_defaults;
+    }
+    for (auto &field : this->fields) {
+      auto default_value =
+          Slot::defaultValue((*this->getSymbol(field.descriptor_index))[0]);
+      if (fieldIs(field, "static")) {
+        this->static_slots[this->getSymbol(field.name_index)] =
+            this->static_defaults.size();
+        this->static_defaults.push_back(default_value);
+        continue;
+      }
+      this->field_slots[this->getSymbol(field.name_index)] =
+          this->field_defaults.size();
+      this->field_defaults.push_back(default_value);
+    }
+    this->laid_out = true;
+  }
+
+  // nullptr se o metodo não tem nenhum handler
+  const HandlerTable *getHandlerTable(
+      const Attributes::Code_attribute *code) const {
+    auto table = this->handler_tables.find(code);
+    return table == this->handler_tables.end() ? nullptr : &table->second;
+  }
+
+  MethodRef_t *getMethodRef(const Types::u2 &index) {
+    auto &ref = this->method_refs[index - 1];
+    if (!ref) {
+      ref.reset(new MethodRef_t());
+      getReference(this->classfile, index, &ref->class_name, &ref->method_name,
+                   &ref->descriptor);
+      ref->arg_slots = getArgSlots(ref->descriptor);
+    }
+    return ref.get();
+  }
+
+  FieldRef_t *getFieldRef(const Types::u2 &index) {
+    auto &ref = this->field_refs[index - 1];
+    if (!ref) {
+      ref.reset(new FieldRef_t());
+      getReference(this->classfile, index, &ref->class_name, &ref->field_name,
+                   &ref->descriptor);
+    }
+    return ref.get();
+  }
+
+  ClassRef_t *getClassRef(const Types::u2 &index) {
+    auto &ref = this->class_refs[index - 1];
+    if (!ref) {
+      ref.reset(new ClassRef_t());
+      ref->name = this->constant_pool[index - 1]
+                      .getClass<ConstantPool::CONSTANT_Class_info>()
+                      ->getValue(this->constant_pool);
+    }
+    return ref.get();
+  }
+
+  /**
+   * @brief the slot of the intern pool of the heap that holds the String of
+   * a CONSTANT_String, nullptr until the first ldc of the entry fills it.
+   * The gc updates the slot, so the reference stays valid when the string
+   * is moved
+   *
+   * @param index
+   * @return Object* const*&
+   */
+  Object *const *&getStringRef(const Types::u2 &index) {
+    return this->string_refs[index - 1];
+  }
+
+  const ClassFile *classfile;
+  const std::vector<ConstantPool::cp_info> &constant_pool;
+  const std::vector<Infos::method_info> &methods;
+  const std::vector<Infos::field_info> &fields;
+  // nome internado na SymbolTable
+  const std::string &name;
+  MemoryAreas::ClassRecord *record = nullptr;
+  bool laid_out = false;
+  // valor inicial de cada slot dos objetos da classe
+  std::vector<Slot> field_defaults;
+  // valor de cada field estático antes do <clinit>
+  std::vector<Slot> static_defaults;
+  // montadas pelo ClassRegistry quando a classe é carregada, que é quem
+  // resolve as classes dos catch
+  std::unordered_map<const Attributes::Code_attribute *, HandlerTable>
+      handler_tables;
+
+ private:
+  Symbol getSymbol(const Types::u2 &index) const {
+    return &this->constant_pool[index - 1]
+                .getClass<ConstantPool::CONSTANT_Utf8_info>()
+                ->getValue();
+  }
+
+  // indices montados quando a classe é carregada
+  std::unordered_map<std::pair<Symbol, Symbol>, const Infos::method_info *,
+                     SymbolPairHash>
+      method_index;
+  std::unordered_map<Symbol, const Infos::field_info *> field_index;
+  std::unordered_map<Symbol, int> field_slots;
+  std::unordered_map<Symbol, int> static_slots;
+  std::vector<std::unique_ptr<MethodRef_t>> method_refs;
+  std::vector<std::unique_ptr<FieldRef_t>> field_refs;
+  std::vector<std::unique_ptr<ClassRef_t>> class_refs;
+  std::vector<Object *const *> string_refs;
+};
+}  // namespace Utils
+
+#endif  // INCLUDE_UTILS_RUNTIME_CLASS_T_H_
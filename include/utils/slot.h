@@ -0,0 +1,185 @@
+#ifndef INCLUDE_UTILS_SLOT_H_
+#define INCLUDE_UTILS_SLOT_H_
+
+#include <cstddef>
+#include <typeinfo>
+
+#include "utils/types.h"
+
+namespace Utils {
+struct Object;
+
+enum slot_tags {
+  kSLOT_EMPTY,
+  kSLOT_INT,
+  kSLOT_LONG,
+  kSLOT_FLOAT,
+  kSLOT_DOUBLE,
+  kSLOT_REFERENCE,
+  // segunda metade de um long/double
+  kSLOT_TOP
+};
+
+template <typename T>
+struct SlotTag;
+
+// quantos slots o valor ocupa na pilha de operandos e nas variaveis locais
+template <typename T>
+struct SlotWidth {
+  enum { value = 1 };
+};
+
+template <>
+struct SlotWidth<long> {
+  enum { value = 2 };
+};
+
+template <>
+struct SlotWidth<double> {
+  enum { value = 2 };
+};
+
+template <>
+struct SlotTag<int> {
+  static const Types::u1 value = kSLOT_INT;
+};
+
+template <>
+struct SlotTag<long> {
+  static const Types::u1 value = kSLOT_LONG;
+};
+
+template <>
+struct SlotTag<float> {
+  static const Types::u1 value = kSLOT_FLOAT;
+};
+
+template <>
+struct SlotTag<double> {
+  static const Types::u1 value = kSLOT_DOUBLE;
+};
+
+template <>
+struct SlotTag<Object *> {
+  static const Types::u1 value = kSLOT_REFERENCE;
+};
+
+/**
+ * @brief a value of the operand stack or of the local variables array. The
+ * value is stored unboxed in 64 bits and the tag says which member of the
+ * union is valid, so no allocation or dynamic_cast is needed to move values
+ * around the frame. The tag sits next to the value, so with the padding a
+ * slot takes 16 bytes. long and double take two slots, the second one is a
+ * top slot
+ */
+class Slot {
+ public:
+  Slot() : tag(kSLOT_EMPTY) { this->value.j = 0; }
+
+  Slot(const int &v) : tag(kSLOT_INT) { this->value.i = v; }
+
+  Slot(const long &v) : tag(kSLOT_LONG) { this->value.j = v; }
+
+  Slot(const float &v) : tag(kSLOT_FLOAT) { this->value.f = v; }
+
+  Slot(const double &v) : tag(kSLOT_DOUBLE) { this->value.d = v; }
+
+  Slot(Object *v) : tag(kSLOT_REFERENCE) { this->value.ref = v; }
+
+  Slot(std::nullptr_t) : tag(kSLOT_REFERENCE) { this->value.ref = nullptr; }
+
+  template <typename T>
+  bool is() const {
+    return this->tag == SlotTag<T>::value;
+  }
+
+  bool isEmpty() const { return this->tag == kSLOT_EMPTY; }
+
+  bool isTop() const { return this->tag == kSLOT_TOP; }
+
+  // long e double são valores de categoria 2
+  bool isWide() const {
+    return this->tag == kSLOT_LONG || this->tag == kSLOT_DOUBLE;
+  }
+
+  template <typename T>
+  T as() const {
+    if (!this->is<T>()) {
+      throw std::bad_cast();
+    }
+    return *const_cast<Slot *>(this)->get<T>();
+  }
+
+  template <typename T>
+  T *reference() {
+    if (!this->is<T>()) {
+      throw std::bad_cast();
+    }
+    return this->get<T>();
+  }
+
+  Types::u1 getTag() const { return this->tag; }
+
+  static Slot top() {
+    Slot slot;
+    slot.tag = kSLOT_TOP;
+    return slot;
+  }
+
+  // valor inicial de um field, pelo primeiro caractere do descritor
+  static Slot defaultValue(const char &type) {
+    switch (type) {
+      case 'J':
+        return Slot(0L);
+      case 'F':
+        return Slot(0.0f);
+      case 'D':
+        return Slot(0.0);
+      case 'L':
+      case '[':
+        return Slot(nullptr);
+    }
+    return Slot(0);
+  }
+
+ private:
+  template <typename T>
+  T *get();
+
+  union {
+    int i;
+    long j;
+    float f;
+    double d;
+    Object *ref;
+  } value;
+  Types::u1 tag;
+};
+
+template <>
+inline int *Slot::get<int>() {
+  return &this->value.i;
+}
+
+template <>
+inline long *Slot::get<long>() {
+  return &this->value.j;
+}
+
+template <>
+inline float *Slot::get<float>() {
+  return &this->value.f;
+}
+
+template <>
+inline double *Slot::get<double>() {
+  return &this->value.d;
+}
+
+template <>
+inline Object **Slot::get<Object *>() {
+  return &this->value.ref;
+}
+}  // namespace Utils
+
+#endif  // INCLUDE_UTILS_SLOT_H_
@@ -0,0 +1,46 @@
+#ifndef INCLUDE_UTILS_STRING_BUILDER_T_H_
+#define INCLUDE_UTILS_STRING_BUILDER_T_H_
+
+#include <algorithm>
+#include <string>
+
+namespace Utils {
+struct Object;
+
+/**
+ * @brief what a java/lang/StringBuilder holds in its data. The appends write
+ * in place at the end of the buffer, which doubles when it is full, so
+ * building a string of n chars copies O(n) chars in total.
+ *
+ * The first toString moves the buffer into the String it creates and keeps
+ * a reference to it in shared, the buffer is only copied back if the builder
+ * is appended to again. That copy happens at most once: a builder appended
+ * to after a toString is marked reused and its next toStrings copy the
+ * buffer instead, so alternating appends and toStrings does not copy the
+ * whole text back on every append. Each of those toStrings still copies the
+ * text into its own String, as in java, the move only saves the copy of the
+ * usual build once and toString once
+ */
+struct StringBuilder_t {
+  // o espaço cresce em dobro, nunca só o que falta
+  void append(const char *text, const size_t &length) {
+    auto needed = this->buffer.size() + length;
+    if (needed > this->buffer.capacity()) {
+      this->buffer.reserve(std::max(needed, 2 * this->buffer.capacity()));
+    }
+    this->buffer.append(text, length);
+  }
+
+  void append(const std::string &text) {
+    this->append(text.data(), text.size());
+  }
+
+  std::string buffer;
+  // String que ficou com o buffer no ultimo toString, o gc atualiza
+  Object *shared = nullptr;
+  // recebeu append depois de um toString, os próximos copiam o buffer
+  bool reused = false;
+};
+}  // namespace Utils
+
+#endif  // INCLUDE_UTILS_STRING_BUILDER_T_H_
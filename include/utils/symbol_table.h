@@ -0,0 +1,44 @@
+#ifndef INCLUDE_UTILS_SYMBOL_TABLE_H_
+#define INCLUDE_UTILS_SYMBOL_TABLE_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace Utils {
+/**
+ * @brief an interned string. Two symbols hold the same text if and only if
+ * they are the same pointer, so they are compared and hashed by identity and
+ * stay valid until the program ends
+ */
+typedef const std::string *Symbol;
+
+namespace SymbolTable {
+/**
+ * @brief returns the symbol of value, creating it on the first call. Every
+ * UTF-8 constant of every loaded class is interned when it is read, so equal
+ * names of different classes share a single string
+ *
+ * @param value
+ * @return Symbol
+ */
+Symbol intern(const std::string &value);
+
+// nullptr se o valor nunca foi internado
+Symbol lookup(const std::string &value);
+
+size_t size();
+}  // namespace SymbolTable
+
+// hash de um par (nome, descritor) de symbols
+struct SymbolPairHash {
+  size_t operator()(const std::pair<Symbol, Symbol> &pair) const {
+    auto first = std::hash<Symbol>()(pair.first);
+    return first ^ (std::hash<Symbol>()(pair.second) + 0x9e3779b9 +
+                    (first << 6) + (first >> 2));
+  }
+};
+}  // namespace Utils
+
+#endif  // INCLUDE_UTILS_SYMBOL_TABLE_H_
@@ -0,0 +1,47 @@
+#ifndef INCLUDE_UTILS_THROWABLE_T_H_
+#define INCLUDE_UTILS_THROWABLE_T_H_
+
+#include <string>
+#include <vector>
+
+namespace Utils {
+struct Object;
+struct RuntimeClass_t;
+namespace Attributes {
+class Code_attribute;
+}  // namespace Attributes
+
+// um frame do stack trace, o metodo é identificado pelo seu atributo Code
+struct TraceFrame {
+  RuntimeClass_t *owner;
+  const Attributes::Code_attribute *code;
+  int pc;
+};
+
+/**
+ * @brief what a throwable holds in its data once it is thrown: the message
+ * given to the constructor and the raw stack trace, captured by the athrow.
+ * Capturing only copies the method and the bytecode offset of each frame,
+ * the names and the line numbers are only looked up when the trace is
+ * printed or asked for
+ */
+struct Throwable_t {
+  std::string message;
+  // do frame que lançou até o do main
+  std::vector<TraceFrame> frames;
+};
+
+/**
+ * @brief the frame as a StackTraceElement prints it, with the line from the
+ * LineNumberTable of the method: Class.method(Source.java:line)
+ *
+ * @param frame
+ * @return std::string
+ */
+std::string symbolize(const TraceFrame &frame);
+
+// o texto do printStackTrace: a classe, a mensagem e um frame por linha
+std::string getStackTraceText(Object *throwable);
+}  // namespace Utils
+
+#endif  // INCLUDE_UTILS_THROWABLE_T_H_
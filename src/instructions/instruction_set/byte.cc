@@ -15,8 +15,11 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   th->current_frame->pushOperand<int>(arrayref->get<int8_t>(index));
   return {};
 }
@@ -29,8 +32,11 @@ std::vector<int> StoreIntoArray::execute(
   }
   auto value = static_cast<int8_t>(th->current_frame->popOperand<int>());
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   arrayref->insert(value, index);
   return {};
 }
@@ -14,9 +14,12 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
-  th->current_frame->pushOperand<int>(arrayref->get<char>(index));
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
+  th->current_frame->pushOperand<int>(arrayref->get<uint16_t>(index));
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -26,10 +29,13 @@ std::vector<int> StoreIntoArray::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto value = static_cast<char>(th->current_frame->popOperand<int>());
+  auto value = static_cast<uint16_t>(th->current_frame->popOperand<int>());
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   arrayref->insert(value, index);
   return {};
 }
@@ -10,6 +10,21 @@
 
 namespace Instructions {
 namespace ConstantPool {
+// a String do pool do heap, o texto só é decodificado no primeiro ldc
+static Utils::Object *loadString(MemoryAreas::Thread *th,
+                                 const Utils::Types::u2 &kpool_index) {
+  auto runtime_class = th->method_area->runtime_class;
+  auto &ref = runtime_class->getStringRef(kpool_index);
+  if (!ref) {
+    auto kstring_info =
+        runtime_class->constant_pool[kpool_index - 1]
+            .getClass<Utils::ConstantPool::CONSTANT_String_info>();
+    ref = th->heap->intern(th,
+                           kstring_info->getValue(runtime_class->constant_pool));
+  }
+  return *ref;
+}
+
 std::vector<int> LoadCat1::execute(
     std::vector<Utils::Types::u1>::iterator *code_iterator,
     MemoryAreas::Thread *th, int *delta_code, const bool &wide, int *pc) {
@@ -18,7 +33,8 @@ std::vector<int> LoadCat1::execute(
   }
 
   unsigned char kpool_index = *++*code_iterator;
-  auto kpool_info = th->method_area->runtime_constant_pool[kpool_index - 1];
+  auto kpool_info =
+      th->method_area->runtime_class->constant_pool[kpool_index - 1];
   switch (kpool_info.base->tag) {
     namespace cp = Utils::ConstantPool;
     case cp::kCONSTANT_INTEGER: {
@@ -33,22 +49,14 @@ std::vector<int> LoadCat1::execute(
       break;
     }
     case cp::kCONSTANT_STRING: {
-      auto kstring_info = kpool_info.getClass<cp::CONSTANT_String_info>();
-      auto objectref = new Utils::Object(
-          kstring_info->getValue(th->method_area->runtime_constant_pool),
-          Utils::Reference::objectref_types::kREF_STRING,
-          Utils::getClassName(th->current_class));
-      auto stringref = th->heap->pushReference(objectref);
-      th->current_frame->pushOperand(stringref);
+      th->current_frame->pushOperand(loadString(th, kpool_index));
       break;
     }
     case cp::kCONSTANT_CLASS: {
       auto kclass_info = kpool_info.getClass<cp::CONSTANT_Class_info>();
-      auto objectref = new Utils::Object(
-          kclass_info->getValue(th->method_area->runtime_constant_pool),
-          Utils::Reference::objectref_types::kREF_CLASS,
-          Utils::getClassName(th->current_class));
-      auto classref = th->heap->pushReference(objectref);
+      auto classref = th->heap->newObject(
+          kclass_info->getValue(th->method_area->runtime_class->constant_pool),
+          th->method_area->runtime_class->record);
       th->current_frame->pushOperand(classref);
       break;
     }
@@ -65,7 +73,8 @@ std::vector<int> LoadCat1Wide::execute(
   }
 
   int16_t kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
-  auto kpool_info = th->method_area->runtime_constant_pool[kpool_index - 1];
+  auto kpool_info =
+      th->method_area->runtime_class->constant_pool[kpool_index - 1];
   switch (kpool_info.base->tag) {
     namespace cp = Utils::ConstantPool;
     case cp::kCONSTANT_INTEGER: {
@@ -80,22 +89,14 @@ std::vector<int> LoadCat1Wide::execute(
       break;
     }
     case cp::kCONSTANT_STRING: {
-      auto kstring_info = kpool_info.getClass<cp::CONSTANT_String_info>();
-      auto objectref = new Utils::Object(
-          kstring_info->getValue(th->method_area->runtime_constant_pool),
-          Utils::Reference::objectref_types::kREF_STRING,
-          Utils::getClassName(th->current_class));
-      auto stringref = th->heap->pushReference(objectref);
-      th->current_frame->pushOperand(stringref);
+      th->current_frame->pushOperand(loadString(th, kpool_index));
       break;
     }
     case cp::kCONSTANT_CLASS: {
       auto kclass_info = kpool_info.getClass<cp::CONSTANT_Class_info>();
-      auto objectref = new Utils::Object(
-          kclass_info->getValue(th->method_area->runtime_constant_pool),
-          Utils::Reference::objectref_types::kREF_CLASS,
-          Utils::getClassName(th->current_class));
-      auto classref = th->heap->pushReference(objectref);
+      auto classref = th->heap->newObject(
+          kclass_info->getValue(th->method_area->runtime_class->constant_pool),
+          th->method_area->runtime_class->record);
       th->current_frame->pushOperand(classref);
       break;
     }
@@ -112,7 +113,8 @@ std::vector<int> LoadCat2::execute(
   }
 
   int16_t kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
-  auto kpool_info = th->method_area->runtime_constant_pool[kpool_index - 1];
+  auto kpool_info =
+      th->method_area->runtime_class->constant_pool[kpool_index - 1];
   switch (kpool_info.base->tag) {
     namespace cp = Utils::ConstantPool;
     case cp::kCONSTANT_LONG: {
@@ -4,6 +4,7 @@
 
 #include "utils/array_t.h"
 #include "utils/flags.h"
+#include "utils/helper_functions.h"
 #include "utils/memory_areas/thread.h"
 #include "utils/object.h"
 
@@ -27,7 +28,7 @@ std::vector<int> ToInteger::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto value = th->current_frame->popOperand<float>();
-  th->current_frame->pushOperand(static_cast<int>(value));
+  th->current_frame->pushOperand(Utils::toIntegral<int>(value));
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -38,7 +39,7 @@ std::vector<int> ToLong::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto value = th->current_frame->popOperand<float>();
-  th->current_frame->pushOperand(static_cast<long>(value));
+  th->current_frame->pushOperand(Utils::toIntegral<long>(value));
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -61,8 +62,11 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   th->current_frame->pushOperand(arrayref->get<float>(index));
   return {};
 }
@@ -75,8 +79,11 @@ std::vector<int> StoreIntoArray::execute(
   }
   auto value = th->current_frame->popOperand<float>();
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   arrayref->insert(value, index);
   return {};
 }
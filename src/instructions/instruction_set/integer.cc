@@ -25,7 +25,7 @@ std::vector<int> ToChar::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto value = th->current_frame->popOperand<int>();
-  th->current_frame->pushOperand<int>(static_cast<char>(value));
+  th->current_frame->pushOperand<int>(static_cast<uint16_t>(value));
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -92,8 +92,11 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   th->current_frame->pushOperand(arrayref->get<int>(index));
   return {};
 }
@@ -118,8 +121,11 @@ std::vector<int> StoreIntoArray::execute(
   }
   auto value = th->current_frame->popOperand<int>();
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   arrayref->insert(value, index);
   return {};
 }
@@ -202,6 +208,10 @@ std::vector<int> Div::execute(
   }
   auto val2 = th->current_frame->popOperand<int>();
   auto val1 = th->current_frame->popOperand<int>();
+  if (!val2) {
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return {};
+  }
   th->current_frame->pushOperand<int>(val1 / val2);
   return {};
 }
@@ -331,6 +341,10 @@ std::vector<int> Rem::execute(
   }
   auto val2 = th->current_frame->popOperand<int>();
   auto val1 = th->current_frame->popOperand<int>();
+  if (!val2) {
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return {};
+  }
   th->current_frame->pushOperand<int>(val1 - (val1 / val2) * val2);
   return {};
 }
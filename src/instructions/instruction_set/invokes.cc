@@ -1,7 +1,9 @@
 #include "instructions/instruction_set/invokes.h"
 
+#include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <memory>
 
 #include "utils/access_flags.h"
 #include "utils/flags.h"
@@ -9,9 +11,46 @@
 #include "utils/memory_areas/method_area.h"
 #include "utils/memory_areas/thread.h"
 #include "utils/object.h"
+#include "utils/string_builder_t.h"
+#include "utils/throwable_t.h"
 
 namespace Instructions {
 namespace Invokes {
+// o texto de uma String ou de um StringBuilder, que pode ter passado o
+// buffer pra String do ultimo toString
+static const std::string &getText(Utils::Object *objectref) {
+  if (objectref->data.is<Utils::StringBuilder_t>()) {
+    auto &builder = objectref->data.as<Utils::StringBuilder_t>();
+    return builder.shared ? builder.shared->data.as<std::string>()
+                          : builder.buffer;
+  }
+  return objectref->data.as<std::string>();
+}
+
+// os argumentos de StringBuilder(), (int capacity), (String) e (CharSequence)
+static void init_string_builder_handler(MemoryAreas::Thread *th,
+                                        const std::string &descriptor) {
+  Utils::StringBuilder_t builder;
+  if (!descriptor.compare("(I)V")) {
+    auto capacity = th->current_frame->popOperand<int>();
+    if (capacity < 0) {
+      th->throwNewException("java/lang/NegativeArraySizeException",
+                            std::to_string(capacity));
+      return;
+    }
+    builder.buffer.reserve(capacity);
+  } else if (descriptor.compare("()V")) {
+    auto arg = th->current_frame->popOperand<Utils::Object *>();
+    if (!arg) {
+      th->throwNewException("java/lang/NullPointerException");
+      return;
+    }
+    builder.append(getText(arg));
+  }
+  auto objectref = th->current_frame->popOperand<Utils::Object *>();
+  objectref->data = std::move(builder);
+}
+
 std::vector<int> Dynamic::execute(
     std::vector<Utils::Types::u1>::iterator *code_iterator,
     MemoryAreas::Thread *th, int *delta_code, const bool &wide, int *pc) {
@@ -27,6 +66,28 @@ std::vector<int> Interface::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
+  auto index = (*++*code_iterator << 8) | *++*code_iterator;
+  // count e o byte 0 que vem depois dele
+  *code_iterator += 2;
+  *delta_code = 4;
+
+  auto ref = th->method_area->runtime_class->getMethodRef(index);
+  // o objectref fica embaixo dos argumentos
+  auto &slot = th->current_frame->getStackTop()[-ref->arg_slots - 1];
+  if (!slot.is<Utils::Object *>()) {
+    throw Utils::Errors::Exception(Utils::Errors::kBADCAST,
+                                   "invalid cast in pop operand");
+  }
+  auto objectref = slot.as<Utils::Object *>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return {};
+  }
+  // o metodo depende da classe do objeto, a entrada guarda o da ultima
+  if (ref->receiver != objectref->klass) {
+    th->method_area->linkInterfaceMethod(ref, objectref->klass);
+  }
+  th->changeContext(ref, true);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -40,44 +101,37 @@ std::vector<int> Especial::execute(
   *delta_code = 2;
   std::stringstream ss;
 
-  std::string classname, methodname, descriptor;
-  Utils::getReference(th->method_area->runtime_classfile, index, &classname,
-                      &methodname, &descriptor);
-
-  // classname != java/lang/StringBuilder e != java/lang/String
-  if (classname.compare("java/lang/StringBuilder") &&
-      classname.compare("java/lang/String") &&
-      classname.compare("java/lang/Exception")) {
-    try {
-      th->changeContext(classname, methodname, descriptor, true);
-    } catch (Utils::Object *obj) {
-      throw obj;
+  auto ref = th->method_area->runtime_class->getMethodRef(index);
+  if (ref->kind == Utils::kINVOKE_UNRESOLVED) {
+    // classname != java/lang/StringBuilder e != java/lang/String
+    if (ref->class_name.compare("java/lang/StringBuilder") &&
+        ref->class_name.compare("java/lang/String") &&
+        ref->class_name.compare("java/lang/Exception")) {
+      th->method_area->linkMethod(ref);
+    } else {
+      ref->kind = Utils::kINVOKE_IGNORED;
     }
-    // auto m = Utils::getMethod(th->method_area->runtime_classfile,
-    // methodname); auto accessflags =
-    // Utils::Access::getMethodAccessType(m.access_flags); if
-    // (std::find(accessflags.begin(), accessflags.end(), "protected") !=
-    //     accessflags.end()) {
+  }
 
-    // }
+  if (ref->kind == Utils::kINVOKE_JAVA) {
+    th->changeContext(ref, true);
+  } else if (!ref->class_name.compare("java/lang/StringBuilder")) {
+    init_string_builder_handler(th, ref->descriptor);
   } else {
     // idealmente era pra popar uma referencia duplicada e rodar o método init.
-    // o init do StringBuilder n precisa de argumentos, mas o do String sim
+    // o init do String precisa do argumento
     // https://stackoverflow.com/questions/12438567/java-bytecode-dup
     std::string string_init_arg = "";
-    // se nao for string builder
-    if (classname.compare("java/lang/StringBuilder")) {
-      // vem do LDC
-      if (th->current_frame->topOperand().is<Utils::Object *>()) {
-        string_init_arg = th->current_frame->popOperand<Utils::Object *>()
-                              ->data.as<std::string>();
-      }
+    // vem do LDC ou de um StringBuilder
+    if (th->current_frame->topOperand().is<Utils::Object *>()) {
+      string_init_arg =
+          getText(th->current_frame->popOperand<Utils::Object *>());
     }
-    auto ref = th->current_frame->popOperand<Utils::Object *>();
-    ref->data = string_init_arg;
+    auto objectref = th->current_frame->popOperand<Utils::Object *>();
+    objectref->data = string_init_arg;
     if (Utils::Flags::options.kDEBUG) {
       std::cout << "Ignorando " << Opcodes::getMnemonic(this->opcode) << " "
-                << (classname + "." + methodname) << "\n";
+                << (ref->class_name + "." + ref->method_name) << "\n";
     }
   }
   return {};
@@ -92,69 +146,99 @@ std::vector<int> Static::execute(
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
   *delta_code = 2;
 
-  std::string classname, methodname, descriptor;
-  Utils::getReference(th->method_area->runtime_classfile, kpool_index,
-                      &classname, &methodname, &descriptor);
-  th->heap->addClass(th, classname);
-  try {
-    th->changeContext(classname, methodname, descriptor, false);
-  } catch (Utils::Object *obj) {
-    throw obj;
+  auto ref = th->method_area->runtime_class->getMethodRef(kpool_index);
+  if (!ref->initialized) {
+    th->heap->addClass(th, ref->class_name);
+    ref->initialized = true;
+  }
+  if (ref->kind == Utils::kINVOKE_UNRESOLVED) {
+    if (!ref->class_name.compare("java/lang/System") &&
+        !ref->method_name.compare("nanoTime")) {
+      ref->kind = Utils::kINVOKE_NANO_TIME;
+    } else if (!ref->class_name.compare("java/lang/System") &&
+               !ref->method_name.compare("currentTimeMillis")) {
+      ref->kind = Utils::kINVOKE_CURRENT_TIME_MILLIS;
+    } else {
+      th->method_area->linkMethod(ref);
+    }
+  }
+
+  switch (ref->kind) {
+    case Utils::kINVOKE_NANO_TIME: {
+      auto now = std::chrono::steady_clock::now().time_since_epoch();
+      th->current_frame->pushOperand<long>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+      break;
+    }
+    case Utils::kINVOKE_CURRENT_TIME_MILLIS: {
+      auto now = std::chrono::system_clock::now().time_since_epoch();
+      th->current_frame->pushOperand<long>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+      break;
+    }
+    default: {
+      th->changeContext(ref, false);
+      break;
+    }
   }
   return {};
 }
 // ----------------------------------------------------------------------------
-static std::string getStringForType(Utils::Frame *frame,
-                                    const std::string &descriptor) {
+// float e double sem casas decimais saem como o java imprime: 1.0
+template <typename T>
+static void appendFloating(const T &val, Utils::StringBuilder_t *out) {
   std::stringstream ss;
+  T integral;
+  if (!std::modf(val, &integral)) {
+    ss << std::fixed << std::setprecision(1) << integral;
+  } else {
+    ss << val;
+  }
+  out->append(ss.str());
+}
+
+// desempilha o argumento do descritor e escreve seu texto no fim de out
+static void appendValue(Utils::Frame *frame, const std::string &descriptor,
+                        Utils::StringBuilder_t *out) {
   // descriptor = (Tipo_argumentos)Tipo_Retorno
   char method_descriptor = descriptor[1];
   switch (method_descriptor) {
     case 'B': {
-      ss << static_cast<int8_t>(frame->popOperand<int>());
+      auto value = static_cast<int8_t>(frame->popOperand<int>());
+      out->append(std::to_string(value));
       break;
     }
     case 'C': {
-      ss << static_cast<char>(frame->popOperand<int>());
+      char c = static_cast<char>(frame->popOperand<int>());
+      out->append(&c, 1);
       break;
     }
     case 'D': {
-      double d;
-      double val = frame->popOperand<double>();
-      if (!std::modf(val, &d)) {
-        ss << std::fixed << std::setprecision(1) << d;
-      } else {
-        ss << val;
-      }
+      appendFloating(frame->popOperand<double>(), out);
       break;
     }
     case 'F': {
-      float f;
-      float val = frame->popOperand<float>();
-      if (!std::modf(val, &f)) {
-        ss << std::fixed << std::setprecision(1) << f;
-      } else {
-        ss << val;
-      }
+      appendFloating(frame->popOperand<float>(), out);
       break;
     }
     case 'I': {
-      ss << frame->popOperand<int>();
+      out->append(std::to_string(frame->popOperand<int>()));
       break;
     }
     case 'J': {
-      ss << frame->popOperand<long>();
+      out->append(std::to_string(frame->popOperand<long>()));
       break;
     }
     case 'S': {
-      ss << static_cast<short>(frame->popOperand<int>());
+      auto value = static_cast<short>(frame->popOperand<int>());
+      out->append(std::to_string(value));
       break;
     }
     case 'Z': {
       if (!frame->popOperand<int>()) {
-        ss << "false";
+        out->append("false", 5);
       } else {
-        ss << "true";
+        out->append("true", 4);
       }
       break;
     }
@@ -168,39 +252,133 @@ static std::string getStringForType(Utils::Frame *frame,
                                        descriptor.find_first_of(';'));
       auto objectref = frame->popOperand<Utils::Object *>();
       if (!objectref) {
-        ss << "null";
+        out->append("null", 4);
         break;
       }
-      if (!refname.compare("Ljava/lang/String;")) {
-        ss << objectref->data.as<std::string>();
+      if (!refname.compare("Ljava/lang/String;") ||
+          !refname.compare("Ljava/lang/CharSequence;") ||
+          !refname.compare("Ljava/lang/StringBuilder;")) {
+        out->append(getText(objectref));
       } else {
+        std::stringstream ss;
         const void *address = static_cast<const void *>(objectref);
         auto classname = refname.substr(1, refname.find_first_of(';') - 1);
         std::replace(classname.begin(), classname.end(), '/', '.');
         ss << classname << "@" << address;
+        out->append(ss.str());
       }
       break;
     }
   }
-  return ss.str();
 }
 
 static std::string print_handler(Utils::Frame *curr_frame,
                                  const std::string &descriptor) {
-  std::stringstream ss;
-  ss << getStringForType(curr_frame, descriptor);
-  return ss.str();
+  Utils::StringBuilder_t text;
+  appendValue(curr_frame, descriptor, &text);
+  return text.buffer;
 }
 
 static void append_handler(MemoryAreas::Thread *th,
                            const std::string &descriptor) {
-  std::stringstream ss;
-  ss << getStringForType(th->current_frame, descriptor);
+  // o builder fica embaixo do argumento
+  auto slots = descriptor[1] == 'D' || descriptor[1] == 'J' ? 2 : 1;
+  auto &slot = th->current_frame->getStackTop()[-slots - 1];
+  if (!slot.is<Utils::Object *>()) {
+    throw Utils::Errors::Exception(Utils::Errors::kBADCAST,
+                                   "invalid cast in pop operand");
+  }
+  auto objectref = slot.as<Utils::Object *>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  auto &builder = objectref->data.as<Utils::StringBuilder_t>();
+  if (builder.shared) {
+    // a String do toString ficou com o buffer, o builder volta a ter o seu
+    builder.buffer = builder.shared->data.as<std::string>();
+    th->heap->writeBarrier(objectref, builder.shared, nullptr);
+    builder.shared = nullptr;
+    builder.reused = true;
+  }
+  appendValue(th->current_frame, descriptor, &builder);
+}
+
+// passa o buffer pra String sem copiar, a copia só acontece se o builder for
+// usado de novo. Um builder reusado fica com o buffer e a String recebe uma
+// cópia, senão cada append depois de um toString copiaria o texto de volta
+static void to_string_handler(MemoryAreas::Thread *th) {
+  auto objectref =
+      th->current_frame->topOperand().as<Utils::Object *>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  auto &builder = objectref->data.as<Utils::StringBuilder_t>();
+  std::string text;
+  if (builder.shared) {
+    text = builder.shared->data.as<std::string>();
+  } else if (builder.reused) {
+    text = builder.buffer;
+  } else {
+    text = std::move(builder.buffer);
+    builder.buffer.clear();
+  }
+
+  // o builder continua na pilha enquanto a String é alocada, a coleta pode
+  // mover ele
+  auto string = th->heap->newObject(std::move(text),
+                                    th->heap->getRecord("java/lang/String"));
+  th->profileAllocation(string);
+  objectref = th->current_frame->popOperand<Utils::Object *>();
+  auto &moved = objectref->data.as<Utils::StringBuilder_t>();
+  if (!moved.shared && !moved.reused) {
+    moved.shared = string;
+    th->heap->writeBarrier(objectref, nullptr, string);
+  }
+  th->current_frame->pushOperand(string);
+}
+
+// printStackTrace vai pro stderr, a linha de cada frame só é procurada aqui
+static void print_stack_trace_handler(MemoryAreas::Thread *th) {
   auto objectref = th->current_frame->popOperand<Utils::Object *>();
-  auto fstr = objectref->data.as<std::string>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  std::cerr << Utils::getStackTraceText(objectref);
+}
+
+// um StackTraceElement por frame, com o texto que o printStackTrace imprime
+static void get_stack_trace_handler(MemoryAreas::Thread *th) {
+  auto objectref = th->current_frame->popOperand<Utils::Object *>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  std::vector<std::string> elements;
+  if (objectref->data.is<Utils::Throwable_t>()) {
+    for (auto &frame : objectref->data.as<Utils::Throwable_t>().frames) {
+      elements.push_back(Utils::symbolize(frame));
+    }
+  }
 
-  objectref->data = fstr + ss.str();
-  th->current_frame->pushOperand(objectref);
+  std::unique_ptr<Utils::Array_t> array_data(
+      new Utils::Array_t(elements.size()));
+  auto array = th->heap->newObject(
+      array_data.get(), th->heap->getRecord("[Ljava/lang/StackTraceElement;"));
+  array_data.release();
+  th->current_frame->pushOperand(array);
+  th->profileAllocation(array);
+  auto element_record = th->heap->getRecord("java/lang/StackTraceElement");
+  for (size_t i = 0; i < elements.size(); ++i) {
+    auto element = th->heap->newObject(elements[i], element_record);
+    th->profileAllocation(element);
+    // a coleta pode ter movido o array, que é relido da pilha
+    auto holder = th->current_frame->topOperand().as<Utils::Object *>();
+    holder->data.as<Utils::Array_t *>()->insert(element, i);
+    th->heap->writeBarrier(holder, nullptr, element);
+  }
 }
 
 std::vector<int> Virtual::execute(
@@ -210,48 +388,84 @@ std::vector<int> Virtual::execute(
   *delta_code = 2;
   std::stringstream ss;
 
-  std::string classname, methodname, descriptor;
-  Utils::getReference(th->method_area->runtime_classfile, index, &classname,
-                      &methodname, &descriptor);
+  auto ref = th->method_area->runtime_class->getMethodRef(index);
+  if (ref->kind == Utils::kINVOKE_UNRESOLVED) {
+    if (!ref->method_name.compare("print")) {
+      ref->kind = Utils::kINVOKE_PRINT;
+    } else if (!ref->method_name.compare("println")) {
+      ref->kind = Utils::kINVOKE_PRINTLN;
+    } else if (!ref->method_name.compare("append")) {
+      ref->kind = Utils::kINVOKE_APPEND;
+    } else if (!ref->class_name.compare("java/lang/StringBuilder") &&
+               !ref->method_name.compare("toString")) {
+      ref->kind = Utils::kINVOKE_TO_STRING;
+    } else if (!ref->method_name.compare("toString")) {
+      ref->kind = Utils::kINVOKE_IGNORED;
+    } else if (!ref->method_name.compare("printStackTrace") &&
+               !ref->descriptor.compare("()V")) {
+      ref->kind = Utils::kINVOKE_PRINT_STACK_TRACE;
+    } else if (!ref->method_name.compare("getStackTrace") &&
+               !ref->descriptor.compare("()[Ljava/lang/StackTraceElement;")) {
+      ref->kind = Utils::kINVOKE_GET_STACK_TRACE;
+    } else if (!ref->class_name.compare("java/lang/String") &&
+               !ref->method_name.compare("intern")) {
+      ref->kind = Utils::kINVOKE_INTERN;
+    } else {
+      th->method_area->linkMethod(ref);
+    }
+  }
 
-  if (!methodname.compare("print") || !methodname.compare("println") ||
-      !methodname.compare("append")) {
-    if (Utils::Flags::options.kDEBUG) {
-      auto ref_val = classname + "." + methodname + ":" + descriptor;
-      std::cout << "Interceptando " << Opcodes::getMnemonic(this->opcode) << " "
-                << ref_val << "\n";
+  switch (ref->kind) {
+    case Utils::kINVOKE_PRINT:
+    case Utils::kINVOKE_PRINTLN:
+    case Utils::kINVOKE_APPEND: {
+      if (Utils::Flags::options.kDEBUG) {
+        auto ref_val =
+            ref->class_name + "." + ref->method_name + ":" + ref->descriptor;
+        std::cout << "Interceptando " << Opcodes::getMnemonic(this->opcode)
+                  << " " << ref_val << "\n";
+      }
+      if (ref->kind == Utils::kINVOKE_APPEND) {
+        append_handler(th, ref->descriptor);
+      } else {
+        std::cout << print_handler(th->current_frame, ref->descriptor);
+      }
+      if (ref->kind == Utils::kINVOKE_PRINTLN) {
+        std::cout << "\n";
+      }
+      break;
     }
-    if (!methodname.compare("append")) {
-      append_handler(th, descriptor);
-    } else {
-      std::cout << print_handler(th->current_frame, descriptor);
+    case Utils::kINVOKE_PRINT_STACK_TRACE: {
+      print_stack_trace_handler(th);
+      break;
+    }
+    case Utils::kINVOKE_GET_STACK_TRACE: {
+      get_stack_trace_handler(th);
+      break;
     }
-    if (!methodname.compare("println")) {
-      std::cout << "\n";
+    case Utils::kINVOKE_TO_STRING: {
+      to_string_handler(th);
+      break;
     }
-  } else {
-    if (Utils::Flags::options.kDEBUG) {
-      std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
+    case Utils::kINVOKE_INTERN: {
+      auto objectref = th->current_frame->popOperand<Utils::Object *>();
+      if (!objectref) {
+        th->throwNewException("java/lang/NullPointerException");
+        return {};
+      }
+      th->current_frame->pushOperand(th->heap->intern(objectref));
+      break;
     }
-    // method != toString
-    if (methodname.compare("toString")) {
-      // for (auto it = th->heap->initialized_classes.begin();
-      //      it != th->heap->initialized_classes.end(); ++it) {
-      //   auto classref = *it;
-      //   classname = th->method_area->getClassThatImplementsMethod(
-      //       classref->class_name, methodname, descriptor);
-      //   if (!classname.empty() && !classref->class_name.compare(classname)) {
-      //     break;
-      //   }
-      try {
-        th->changeContext(classname, methodname, descriptor, true);
-      } catch (Utils::Object *obj) {
-        throw obj;
+    default: {
+      if (Utils::Flags::options.kDEBUG) {
+        std::cout << "Executando " << Opcodes::getMnemonic(this->opcode)
+                  << "\n";
       }
-      //   break;
-      // } catch (...) {
-      // }
-      // }
+      // method != toString
+      if (ref->kind == Utils::kINVOKE_JAVA) {
+        th->changeContext(ref, true);
+      }
+      break;
     }
   }
   return {};
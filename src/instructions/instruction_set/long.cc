@@ -59,8 +59,11 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   th->current_frame->pushOperand(arrayref->get<long>(index));
   return {};
 }
@@ -85,8 +88,11 @@ std::vector<int> StoreIntoArray::execute(
   }
   auto value = th->current_frame->popOperand<long>();
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   arrayref->insert(value, index);
   return {};
 }
@@ -138,6 +144,10 @@ std::vector<int> Div::execute(
 
   auto val2 = th->current_frame->popOperand<long>();
   auto val1 = th->current_frame->popOperand<long>();
+  if (!val2) {
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return {};
+  }
   th->current_frame->pushOperand<long>(val1 / val2);
   return {};
 }
@@ -245,6 +255,10 @@ std::vector<int> Rem::execute(
   }
   auto val2 = th->current_frame->popOperand<long>();
   auto val1 = th->current_frame->popOperand<long>();
+  if (!val2) {
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return {};
+  }
   th->current_frame->pushOperand<long>(val1 - (val1 / val2) * val2);
   return {};
 }
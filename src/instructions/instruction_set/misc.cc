@@ -1,10 +1,10 @@
 #include "instructions/instruction_set/misc.h"
 
+#include <cstdint>
 #include <memory>
 
 #include "utils/access_flags.h"
 #include "utils/array_t.h"
-#include "utils/field_t.h"
 #include "utils/flags.h"
 #include "utils/memory_areas/heap.h"
 #include "utils/memory_areas/method_area.h"
@@ -13,6 +13,62 @@
 
 namespace Instructions {
 namespace Misc {
+// o que o multianewarray sabe sobre o array que está criando
+struct MultiArrayShape {
+  std::vector<int> counts;
+  // registro da classe dos arrays de cada nivel
+  std::vector<MemoryAreas::ClassRecord *> records;
+  // atype dos elementos da ultima dimensão
+  int leaf_type = 0;
+  // elementos da ultima dimensão, uma linha depois da outra
+  std::shared_ptr<std::vector<Utils::Types::u1>> block;
+  size_t offset = 0;
+};
+
+/**
+ * @brief creates the arrays of the level below the array of a level, laying
+ * the rows of the last dimension out in the block of the shape. A
+ * collection may move the object that holds array, so it is read again from
+ * outer, or from the operand stack on the first level, for the barrier
+ *
+ * @param th
+ * @param shape
+ * @param level
+ * @param array
+ * @param outer the array of the level above, nullptr on the first level
+ * @param index where the object of array is in outer
+ */
+static void fillMultiArray(MemoryAreas::Thread *th, MultiArrayShape *shape,
+                           const int &level, Utils::Array_t *array,
+                           Utils::Array_t *outer, const int &index) {
+  auto inner = level + 1;
+  if (inner == static_cast<int>(shape->counts.size())) {
+    return;
+  }
+  auto leaf = inner + 1 == static_cast<int>(shape->counts.size());
+  for (int i = 0; i < shape->counts[level]; ++i) {
+    // o heap pode lançar out of memory, então a linha só passa a ser do
+    // objeto depois que ele existe
+    std::unique_ptr<Utils::Array_t> row_data;
+    if (leaf) {
+      row_data.reset(new Utils::Array_t(shape->counts[inner], shape->leaf_type,
+                                        shape->block, shape->offset));
+      shape->offset += row_data->bytes();
+    } else {
+      row_data.reset(new Utils::Array_t(shape->counts[inner]));
+    }
+    auto rowobj = th->heap->newObject(row_data.get(), shape->records[inner]);
+    auto row = row_data.release();
+    th->profileAllocation(rowobj);
+    array->insert(rowobj, i);
+    auto holder =
+        outer ? outer->get<Utils::Object *>(index)
+              : th->current_frame->getStackTop()[-1].as<Utils::Object *>();
+    th->heap->writeBarrier(holder, nullptr, rowobj);
+    fillMultiArray(th, shape, inner, row, array, i);
+  }
+}
+// ----------------------------------------------------------------------------
 std::vector<int> Checkcast::execute(
     std::vector<Utils::Types::u1>::iterator *code_iterator,
     MemoryAreas::Thread *th, int *delta_code, const bool &wide, int *pc) {
@@ -28,10 +84,10 @@ std::vector<int> Dup::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto val = th->current_frame->popOperand<Any>();
+  auto val = th->current_frame->popSlot();
 
-  th->current_frame->pushOperand(val);
-  th->current_frame->pushOperand(val);
+  th->current_frame->pushSlot(val);
+  th->current_frame->pushSlot(val);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -41,12 +97,12 @@ std::vector<int> DupX1::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto val1 = th->current_frame->popOperand<Any>();
-  auto val2 = th->current_frame->popOperand<Any>();
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
 
-  th->current_frame->pushOperand(val1);
-  th->current_frame->pushOperand(val2);
-  th->current_frame->pushOperand(val1);
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -56,24 +112,16 @@ std::vector<int> DupX2::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto val1 = th->current_frame->popOperand<Any>();  // cat1
-  // cat2
-  if (th->current_frame->topOperand().is<long>() ||
-      th->current_frame->topOperand().is<double>()) {
-    auto val2 = th->current_frame->popOperand<Any>();
-
-    th->current_frame->pushOperand(val1);
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-  } else {
-    auto val2 = th->current_frame->popOperand<Any>();
-    auto val3 = th->current_frame->popOperand<Any>();
+  // long e double ocupam 2 slots, então as duas formas da instrução viram uma
+  // só quando se trabalha com os slots
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
+  auto val3 = th->current_frame->popSlot();
 
-    th->current_frame->pushOperand(val1);
-    th->current_frame->pushOperand(val3);
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-  }
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val3);
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -83,24 +131,13 @@ std::vector<int> Dup2::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
 
-  // se é cat2
-  if (th->current_frame->topOperand().is<long>() ||
-      th->current_frame->topOperand().is<double>()) {
-    auto val = th->current_frame->popOperand<Any>();
-
-    th->current_frame->pushOperand(val);
-    th->current_frame->pushOperand(val);
-  } else {
-    auto val1 = th->current_frame->popOperand<Any>();
-    auto val2 = th->current_frame->popOperand<Any>();
-
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-  }
-
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -110,27 +147,15 @@ std::vector<int> Dup2X1::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
+  auto val3 = th->current_frame->popSlot();
 
-  // cat2
-  if (th->current_frame->topOperand().is<long>() ||
-      th->current_frame->topOperand().is<double>()) {
-    auto val1 = th->current_frame->popOperand<Any>();
-    auto val2 = th->current_frame->popOperand<Any>();
-
-    th->current_frame->pushOperand(val1);
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-  } else {
-    auto val1 = th->current_frame->popOperand<Any>();
-    auto val2 = th->current_frame->popOperand<Any>();
-    auto val3 = th->current_frame->popOperand<Any>();
-
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-    th->current_frame->pushOperand(val3);
-    th->current_frame->pushOperand(val2);
-    th->current_frame->pushOperand(val1);
-  }
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val3);
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -140,54 +165,17 @@ std::vector<int> Dup2X2::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  // cat2
-  if (th->current_frame->topOperand().is<long>() ||
-      th->current_frame->topOperand().is<double>()) {
-    auto val1 = th->current_frame->popOperand<Any>();
-    // se o proximo tbm for cat2
-    if (th->current_frame->topOperand().is<long>() ||
-        th->current_frame->topOperand().is<double>()) {
-      auto val2 = th->current_frame->popOperand<Any>();
-
-      th->current_frame->pushOperand(val1);
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-    } else {
-      // val2 e 3 sao cat1
-      auto val2 = th->current_frame->popOperand<Any>();
-      auto val3 = th->current_frame->popOperand<Any>();
-
-      th->current_frame->pushOperand(val1);
-      th->current_frame->pushOperand(val3);
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-    }
-  } else {
-    // val1 é cat1
-    auto val1 = th->current_frame->popOperand<Any>();
-    auto val2 = th->current_frame->popOperand<Any>();
-    // se val3 é cat2
-    if (th->current_frame->topOperand().is<long>() ||
-        th->current_frame->topOperand().is<double>()) {
-      auto val3 = th->current_frame->popOperand<Any>();
-
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-      th->current_frame->pushOperand(val3);
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-    } else {
-      auto val3 = th->current_frame->popOperand<Any>();
-      auto val4 = th->current_frame->popOperand<Any>();
-
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-      th->current_frame->pushOperand(val4);
-      th->current_frame->pushOperand(val3);
-      th->current_frame->pushOperand(val2);
-      th->current_frame->pushOperand(val1);
-    }
-  }
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
+  auto val3 = th->current_frame->popSlot();
+  auto val4 = th->current_frame->popSlot();
+
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val4);
+  th->current_frame->pushSlot(val3);
+  th->current_frame->pushSlot(val2);
+  th->current_frame->pushSlot(val1);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -201,40 +189,24 @@ std::vector<int> GetField::execute(
   *delta_code = 2;
 
   auto objectref = th->current_frame->popOperand<Utils::Object *>();
-  auto classname_and_field_str =
-      th->current_class->constant_pool[kpool_index - 1]
-          .getClass<Utils::ConstantPool::CONSTANT_FieldRef_info>()
-          ->getValue(th->current_class->constant_pool, true);
-  auto classname = classname_and_field_str.substr(
-      0, classname_and_field_str.find_last_of('.'));
-  auto field_name = classname_and_field_str.substr(
-      classname_and_field_str.find_last_of('.') + 1);
-
-  auto old_class = th->current_class;
-  // muda o contexto para onde o field vai estar
-  th->method_area->update(th->method_area->getClass(classname));
-  auto field = th->method_area->getField(field_name);
-  auto field_access = Utils::Access::getFieldAccessType(field.access_flags);
+  auto ref = th->method_area->runtime_class->getFieldRef(kpool_index);
+  if (!ref->resolved) {
+    th->method_area->linkField(ref);
+  }
 
-  if (std::find_if(field_access.begin(), field_access.end(),
-                   [](const std::string &s) { return !s.compare("static"); }) !=
-      field_access.end()) {
-    throw Utils::Errors::JvmException(
-        Utils::Errors::java_exceptions::kINCOMPATIBLECLASSCHANGE,
-        "IncompatibleClassChangeError");
+  if (ref->is_static) {
+    th->throwNewException("java/lang/IncompatibleClassChangeError",
+                          "Expected non-static field " + ref->class_name +
+                              "." + ref->field_name);
+    return {};
   }
 
   if (objectref == nullptr) {
-    throw Utils::Errors::JvmException(
-        Utils::Errors::java_exceptions::kNULLPOINTEREXCEPTION,
-        "NullPointerException");
+    th->throwNewException("java/lang/NullPointerException");
+    return {};
   }
 
-  auto field_val = objectref->fields[field_name]->data;
-  th->current_frame->pushOperand(field_val);
-
-  // retorna o contexto para a classe antiga
-  th->method_area->update(old_class);
+  th->current_frame->pushOperand(objectref->getFields()[ref->slot]);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -244,30 +216,41 @@ std::vector<int> GetStatic::execute(
   auto index = (*++*code_iterator << 8) | *++*code_iterator;
   *delta_code = 2;
 
-  std::string classname, field_name, descriptor;
-  Utils::getReference(th->method_area->runtime_classfile, index, &classname,
-                      &field_name, &descriptor);
+  auto ref = th->method_area->runtime_class->getFieldRef(index);
+  if (!ref->resolved) {
+    // se classname.field_name != java/lang/System.out ai carrega a classe, tem
+    // que inicializar e os krl ainda
+    ref->ignored = !ref->class_name.compare("java/lang/System") &&
+                   !ref->field_name.compare("out");
+    if (!ref->ignored) {
+      auto old_class = th->current_class;
+      // muda o contexto para onde o field vai estar
+      if (!th->method_area->isLoaded(ref->class_name)) {
+        th->method_area->update(th->method_area->getClass(ref->class_name));
+      }
+      th->heap->addClass(th, ref->class_name);
+      ref->statics = th->heap->getClass(ref->class_name);
+      th->method_area->update(old_class);
+      // putstatic usa a mesma entrada e confia no is_static
+      th->method_area->linkField(ref);
+    }
+    ref->resolved = true;
+  }
 
-  // se classname.field_name != java/lang/System.out ai carrega a classe, tem
-  // que inicializar e os krl ainda
-  if ((classname + "." + field_name)
-          .compare(std::string("java/lang/System.out"))) {
+  if (!ref->ignored) {
     if (Utils::Flags::options.kDEBUG) {
       std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
     }
-    auto old_class = th->current_class;
-    // muda o contexto para onde o field vai estar
-    if (!th->method_area->isLoaded(classname)) {
-      th->method_area->update(th->method_area->getClass(classname));
+    if (!ref->is_static) {
+      th->throwNewException("java/lang/IncompatibleClassChangeError",
+                            "Expected static field " + ref->class_name + "." +
+                                ref->field_name);
+      return {};
     }
-    th->heap->addClass(th, classname);
-    auto field_val = th->heap->getClass(classname)->getField(field_name)->data;
-    th->current_frame->pushOperand(field_val);
-
-    th->method_area->update(old_class);
+    th->current_frame->pushOperand(ref->statics->fields[ref->slot]);
   } else if (Utils::Flags::options.kDEBUG) {
     std::cout << "Ignorando " << Opcodes::getMnemonic(this->opcode) << " "
-              << (classname + "." + field_name) << "\n";
+              << (ref->class_name + "." + ref->field_name) << "\n";
   }
   return {};
 }
@@ -366,28 +349,47 @@ std::vector<int> MultiDimArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
-  auto classname = th->method_area->runtime_constant_pool[kpool_index - 1]
-                       .getClass<Utils::ConstantPool::CONSTANT_Class_info>()
-                       ->getValue(th->method_area->runtime_constant_pool);
+  auto ref = th->method_area->runtime_class->getClassRef(kpool_index);
+  if (!ref->record) {
+    ref->record = th->heap->getRecord(ref->name);
+  }
   int dims = *++*code_iterator;
   *delta_code = 3;
 
-  auto inner_to_outer_dimensions = new int[dims];
+  MultiArrayShape shape;
+  shape.counts.resize(dims);
   for (int i = dims - 1; i >= 0; --i) {
-    inner_to_outer_dimensions[i] = th->current_frame->popOperand<int>();
-    if (!inner_to_outer_dimensions[i]) {
-      break;
+    shape.counts[i] = th->current_frame->popOperand<int>();
+  }
+  size_t elements = 1;
+  for (auto count : shape.counts) {
+    if (count < 0) {
+      th->throwNewException("java/lang/NegativeArraySizeException",
+                            std::to_string(count));
+      return {};
     }
+    elements *= count;
   }
+  shape.records.push_back(ref->record);
+  for (int level = 1; level < dims; ++level) {
+    shape.records.push_back(th->heap->getRecord(ref->name.substr(level)));
+  }
+  shape.leaf_type = Utils::Array_t::getElementType(ref->name.substr(dims - 1));
 
-  auto multiarray = new Utils::MultiArray_t(dims, inner_to_outer_dimensions);
-  auto objectref = new Utils::Object(multiarray->arrays,
-                                     Utils::Reference::kREF_ARRAY, classname);
-
-  th->current_frame->pushOperand(th->heap->pushReference(objectref));
-
-  delete[] inner_to_outer_dimensions;
-
+  std::unique_ptr<Utils::Array_t> array_data;
+  if (dims == 1) {
+    array_data.reset(new Utils::Array_t(shape.counts[0], shape.leaf_type));
+  } else {
+    shape.block = std::make_shared<std::vector<Utils::Types::u1>>(
+        elements * Utils::Array_t::getElementSize(shape.leaf_type));
+    array_data.reset(new Utils::Array_t(shape.counts[0]));
+  }
+  // na pilha o array já é raiz do gc enquanto as linhas são criadas
+  auto objectref = th->heap->newObject(array_data.get(), ref->record);
+  auto array = array_data.release();
+  th->current_frame->pushOperand(objectref);
+  th->profileAllocation(objectref);
+  fillMultiArray(th, &shape, 0, array, nullptr, 0);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -399,23 +401,35 @@ std::vector<int> New::execute(
   }
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
   *delta_code = 2;
-  auto kpool_info = th->current_class->constant_pool[kpool_index - 1];
+  auto ref = th->method_area->runtime_class->getClassRef(kpool_index);
 
-  auto classname =
-      kpool_info.getClass<Utils::ConstantPool::CONSTANT_Class_info>()->getValue(
-          th->current_class->constant_pool);
+  if (ref->initialized) {
+    auto objectref = ref->runtime_class
+                         ? th->heap->newInstance(ref->runtime_class)
+                         : th->heap->newObject(ref->record);
+    th->current_frame->pushOperand(objectref);
+    th->profileAllocation(objectref);
+    return {};
+  }
 
   auto old_class = th->current_class;
   // classname != java/lang/StringBuilder e != java/lang/String
-  if (classname.compare("java/lang/StringBuilder") &&
-      classname.compare("java/lang/String") &&
-      classname.compare("java/lang/Exception")) {
-    th->method_area->update(th->method_area->getClass(classname));
-  }
-
-  auto objectref = new Utils::Object(classname);
-  th->current_frame->pushOperand(th->heap->pushReference(objectref));
-  th->heap->addClass(th, classname);
+  if (ref->name.compare("java/lang/StringBuilder") &&
+      ref->name.compare("java/lang/String") &&
+      ref->name.compare("java/lang/Exception")) {
+    th->method_area->update(th->method_area->getClass(ref->name));
+    ref->runtime_class = th->method_area->runtime_class;
+    th->method_area->layoutFields(ref->runtime_class);
+  }
+  ref->record = th->heap->getRecord(ref->name);
+
+  auto objectref = ref->runtime_class
+                       ? th->heap->newInstance(ref->runtime_class)
+                       : th->heap->newObject(ref->record);
+  th->current_frame->pushOperand(objectref);
+  th->profileAllocation(objectref);
+  th->heap->addClass(th, ref->name);
+  ref->initialized = true;
 
   th->method_area->update(old_class);
   return {};
@@ -431,15 +445,18 @@ std::vector<int> NewArray::execute(
   unsigned char atype = *++*code_iterator;
   auto count = th->current_frame->popOperand<int>();
 
-  if (!count) {
-    throw Utils::Errors::JvmException(Utils::Errors::kNEGATIVEARRAYSIZE,
-                                      "NegativeArraySizeException");
+  if (count < 0) {
+    th->throwNewException("java/lang/NegativeArraySizeException",
+                          std::to_string(count));
+    return {};
   }
 
-  auto arr = new Utils::Array_t(count, atype);
-  auto objectref = new Utils::Object(arr, Utils::Reference::kREF_ARRAY,
-                                     Utils::getClassName(th->current_class));
-  th->current_frame->pushOperand(th->heap->pushReference(objectref));
+  std::unique_ptr<Utils::Array_t> arr(new Utils::Array_t(count, atype));
+  auto objectref = th->heap->newObject(
+      arr.get(), th->heap->getRecord(Utils::Array_t::getDescriptor(atype)));
+  arr.release();
+  th->current_frame->pushOperand(objectref);
+  th->profileAllocation(objectref);
 
   *delta_code = 1;
   return {};
@@ -460,7 +477,7 @@ std::vector<int> Pop::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  th->current_frame->popOperand<Any>();
+  th->current_frame->popSlot();
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -470,16 +487,8 @@ std::vector<int> Pop2::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-
-  // cat 1
-  if (!th->current_frame->topOperand().is<long>() &&
-      !th->current_frame->topOperand().is<double>()) {
-    th->current_frame->popOperand<Any>();
-    th->current_frame->popOperand<Any>();
-  } else {
-    th->current_frame->popOperand<Any>();
-  }
-
+  th->current_frame->popSlot();
+  th->current_frame->popSlot();
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -492,35 +501,29 @@ std::vector<int> PutField::execute(
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
   *delta_code = 2;
 
-  auto classname_and_field_str =
-      th->current_class->constant_pool[kpool_index - 1]
-          .getClass<Utils::ConstantPool::CONSTANT_FieldRef_info>()
-          ->getValue(th->current_class->constant_pool, true);
-
-  auto field_name = classname_and_field_str.substr(
-      classname_and_field_str.find_last_of('.') + 1);
-  auto field = th->method_area->getField(field_name);
+  auto ref = th->method_area->runtime_class->getFieldRef(kpool_index);
+  if (!ref->resolved) {
+    th->method_area->linkField(ref);
+  }
 
-  auto val = th->current_frame->popOperand<Any>();
+  auto val = th->current_frame->popOperand<Utils::Slot>();
   auto objectref = th->current_frame->popOperand<Utils::Object *>();
 
-  auto field_access = Utils::Access::getFieldAccessType(field.access_flags);
-
-  if (std::find_if(field_access.begin(), field_access.end(),
-                   [](const std::string &s) { return !s.compare("static"); }) !=
-      field_access.end()) {
-    throw Utils::Errors::JvmException(
-        Utils::Errors::java_exceptions::kINCOMPATIBLECLASSCHANGE,
-        "IncompatibleClassChangeError");
+  if (ref->is_static) {
+    th->throwNewException("java/lang/IncompatibleClassChangeError",
+                          "Expected non-static field " + ref->class_name +
+                              "." + ref->field_name);
+    return {};
   }
 
   if (objectref == nullptr) {
-    throw Utils::Errors::JvmException(
-        Utils::Errors::java_exceptions::kNULLPOINTEREXCEPTION,
-        "NullPointerException");
+    th->throwNewException("java/lang/NullPointerException");
+    return {};
   }
 
-  objectref->addField(field_name, new Utils::Field_t(val));
+  auto &field = objectref->getFields()[ref->slot];
+  th->heap->writeBarrier(objectref, field, val);
+  field = val;
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -533,45 +536,28 @@ std::vector<int> PutStatic::execute(
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
   *delta_code = 2;
 
-  auto kfieldref_info =
-      th->current_class->constant_pool[kpool_index - 1]
-          .getClass<Utils::ConstantPool::CONSTANT_FieldRef_info>();
-
-  auto classname_and_field_str =
-      kfieldref_info->getValue(th->current_class->constant_pool, true);
-
-  auto descriptor =
-      th->method_area
-          ->runtime_constant_pool[kfieldref_info->name_and_type_index - 1]
-          .getClass<Utils::ConstantPool::CONSTANT_NameAndType_info>()
-          ->getValue(th->current_class->constant_pool);
-
-  descriptor = descriptor.substr(descriptor.find_last_of(':'));
-
-  auto classname = classname_and_field_str.substr(
-      0, classname_and_field_str.find_last_of('.'));
-  auto field_name = classname_and_field_str.substr(
-      classname_and_field_str.find_last_of('.') + 1);
-
-  auto old_class = th->current_class;
-  // muda o contexto para onde o field vai estar
-  th->method_area->update(th->method_area->getClass(classname));
-  th->heap->addClass(th, classname);
-
-  auto field = th->method_area->getField(field_name);
-  auto val = th->current_frame->popOperand<Any>();
-  auto field_access = Utils::Access::getFieldAccessType(field.access_flags);
+  auto ref = th->method_area->runtime_class->getFieldRef(kpool_index);
+  if (!ref->resolved) {
+    auto old_class = th->current_class;
+    // muda o contexto para onde o field vai estar
+    th->method_area->update(th->method_area->getClass(ref->class_name));
+    th->heap->addClass(th, ref->class_name);
+    th->method_area->update(old_class);
+    th->method_area->linkField(ref);
+    ref->statics = th->heap->getClass(ref->class_name);
+  }
 
-  if (std::find_if(field_access.begin(), field_access.end(),
-                   [](const std::string &s) { return !s.compare("static"); }) ==
-      field_access.end()) {
-    throw Utils::Errors::JvmException(
-        Utils::Errors::java_exceptions::kINCOMPATIBLECLASSCHANGE,
-        "IncompatibleClassChangeError");
+  auto val = th->current_frame->popOperand<Utils::Slot>();
+  if (!ref->is_static) {
+    th->throwNewException("java/lang/IncompatibleClassChangeError",
+                          "Expected static field " + ref->class_name + "." +
+                              ref->field_name);
+    return {};
   }
 
-  th->heap->getClass(classname)->addField(val, field_name, descriptor);
-  th->method_area->update(old_class);
+  auto &field = ref->statics->fields[ref->slot];
+  th->heap->writeBarrier(ref->statics, field, val);
+  field = val;
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -591,7 +577,7 @@ std::vector<int> Ret::execute(
   }
 
   auto delta_pc = *pc;
-  *pc = th->current_frame->getLocalVarValue<Any>(index).as<int>();
+  *pc = th->current_frame->getLocalVarValue<int>(index);
   delta_pc = *pc - delta_pc;
 
   *code_iterator += (delta_pc - *delta_code - 1);
@@ -616,11 +602,11 @@ std::vector<int> Swap::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto val1 = th->current_frame->popOperand<Any>();
-  auto val2 = th->current_frame->popOperand<Any>();
+  auto val1 = th->current_frame->popSlot();
+  auto val2 = th->current_frame->popSlot();
 
-  th->current_frame->pushOperand(val2);
-  th->current_frame->pushOperand(val1);
+  th->current_frame->pushSlot(val1);
+  th->current_frame->pushSlot(val2);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -647,11 +633,12 @@ std::vector<int> TableSwitch::execute(
   auto default_bytes = getU4(code_iterator);
   auto low = getU4(code_iterator);
   auto high = getU4(code_iterator);
-  auto qtd_entries = high - low + 1;
-  auto index = th->current_frame->popOperand<int>();
+  // em 64 bits pra não estourar quando high é INT_MAX ou low é INT_MIN
+  auto qtd_entries = static_cast<int64_t>(high) - low + 1;
+  auto index = static_cast<int64_t>(th->current_frame->popOperand<int>()) - low;
   auto base_delta_code = getAlinhamento(alinhamento) + 4 + 4 + 4;
 
-  for (int i = low; i < high + 1; ++i) {
+  for (int64_t i = 0; i < qtd_entries; ++i) {
     auto offset = static_cast<int>(getU4(code_iterator));
     *delta_code = base_delta_code + (4 * (i + 1));
 
@@ -1,5 +1,7 @@
 #include "instructions/instruction_set/reference.h"
 
+#include <memory>
+
 #include "utils/array_t.h"
 #include "utils/flags.h"
 #include "utils/memory_areas/heap.h"
@@ -17,8 +19,11 @@ std::vector<int> LoadFromArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   int index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayref = th->getArray(
+      th->current_frame->popOperand<Utils::Object *>(), index);
+  if (!arrayref) {
+    return {};
+  }
   th->current_frame->pushOperand(arrayref->get<Utils::Object *>(index));
   return {};
 }
@@ -32,9 +37,14 @@ std::vector<int> StoreIntoArray::execute(
   }
   auto value = th->current_frame->popOperand<Utils::Object *>();
   auto index = th->current_frame->popOperand<int>();
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto arrayobj = th->current_frame->popOperand<Utils::Object *>();
+  auto arrayref = th->getArray(arrayobj, index);
+  if (!arrayref) {
+    return {};
+  }
+  auto old_value = arrayref->get<Utils::Object *>(index);
   arrayref->insert(value, index);
+  th->heap->writeBarrier(arrayobj, old_value, value);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -126,23 +136,27 @@ std::vector<int> NewArray::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto kpool_index = (*++*code_iterator << 8) | *++*code_iterator;
-  auto classname = th->method_area->runtime_constant_pool[kpool_index - 1]
-                       .getClass<Utils::ConstantPool::CONSTANT_Class_info>()
-                       ->getValue(th->method_area->runtime_constant_pool);
+  auto ref = th->method_area->runtime_class->getClassRef(kpool_index);
+  if (!ref->record) {
+    ref->record = th->heap->getRecord(ref->name);
+  }
   *delta_code = 2;
 
   auto count = th->current_frame->popOperand<int>();
 
-  if (!count) {
-    throw Utils::Errors::JvmException(Utils::Errors::kNEGATIVEARRAYSIZE,
-                                      "NegativeArraySizeException");
+  if (count < 0) {
+    th->throwNewException("java/lang/NegativeArraySizeException",
+                          std::to_string(count));
+    return {};
   }
 
-  auto arr = new Utils::Array_t(count, Utils::Reference::kREF_CLASS);
-  auto objectref =
-      new Utils::Object(arr, Utils::Reference::kREF_ARRAY, classname);
+  std::unique_ptr<Utils::Array_t> arr(
+      new Utils::Array_t(count, Utils::Reference::kREF_CLASS));
+  auto objectref = th->heap->newObject(arr.get(), ref->record);
+  arr.release();
 
-  th->current_frame->pushOperand(th->heap->pushReference(objectref));
+  th->current_frame->pushOperand(objectref);
+  th->profileAllocation(objectref);
   return {};
 }
 // ----------------------------------------------------------------------------
@@ -166,8 +180,12 @@ std::vector<int> ArrayLength::execute(
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
-  auto arrayref = th->current_frame->popOperand<Utils::Object *>()
-                      ->data.as<Utils::Array_t *>();
+  auto objectref = th->current_frame->popOperand<Utils::Object *>();
+  if (!objectref) {
+    th->throwNewException("java/lang/NullPointerException");
+    return {};
+  }
+  auto arrayref = objectref->data.as<Utils::Array_t *>();
 
   th->current_frame->pushOperand(arrayref->length());
   return {};
@@ -251,8 +269,12 @@ std::vector<int> Throw::execute(
     std::cout << "Executando " << Opcodes::getMnemonic(this->opcode) << "\n";
   }
   auto objectref = th->current_frame->popOperand<Utils::Object *>();
-  // ??
-  throw objectref;
+  if (objectref == nullptr) {
+    th->throwNewException("java/lang/NullPointerException");
+    return {};
+  }
+  // quem procura o handler é o loop de execução, depois da instrução
+  th->throwException(objectref);
   return {};
 }
 }  // namespace Reference
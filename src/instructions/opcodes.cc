@@ -1,6 +1,7 @@
 #include "instructions/opcodes.h"
 
 #include <map>
+#include <stdexcept>
 
 namespace Instructions {
 namespace Opcodes {
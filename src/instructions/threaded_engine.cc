@@ -0,0 +1,1327 @@
+#include "instructions/threaded_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "instructions/instruction_set/base.h"
+#include "instructions/instruction_set/constant_pool.h"
+#include "instructions/instruction_set/invokes.h"
+#include "instructions/instruction_set/misc.h"
+#include "instructions/instruction_set/monitor.h"
+#include "instructions/instruction_set/reference.h"
+#include "instructions/opcodes.h"
+#include "utils/array_t.h"
+#include "utils/errors.h"
+#include "utils/flags.h"
+#include "utils/helper_functions.h"
+#include "utils/memory_areas/heap.h"
+#include "utils/memory_areas/thread.h"
+#include "utils/object.h"
+
+namespace Instructions {
+// Só as instruções que não são tratadas direto no loop de dispatch precisam de
+// um objeto Instruction. Elas não guardam estado, então basta uma instância
+// de cada, criada na primeira vez que o opcode aparece.
+static Instruction *createInstruction(const Utils::Types::u1 &opcode) {
+  switch (opcode) {
+    case Opcodes::kANEWARRAY:
+      return new Reference::NewArray();
+    case Opcodes::kATHROW:
+      return new Reference::Throw();
+    case Opcodes::kCHECKCAST:
+      return new Misc::Checkcast();
+    case Opcodes::kGETFIELD:
+      return new Misc::GetField();
+    case Opcodes::kGETSTATIC:
+      return new Misc::GetStatic();
+    case Opcodes::kINSTANCEOF:
+      return new Misc::InstanceOf();
+    case Opcodes::kINVOKEDYNAMIC:
+      return new Invokes::Dynamic();
+    case Opcodes::kINVOKEINTERFACE:
+      return new Invokes::Interface();
+    case Opcodes::kINVOKESPECIAL:
+      return new Invokes::Especial();
+    case Opcodes::kINVOKESTATIC:
+      return new Invokes::Static();
+    case Opcodes::kINVOKEVIRTUAL:
+      return new Invokes::Virtual();
+    case Opcodes::kLDC:
+      return new ConstantPool::LoadCat1();
+    case Opcodes::kLDC_W:
+      return new ConstantPool::LoadCat1Wide();
+    case Opcodes::kLDC2_W:
+      return new ConstantPool::LoadCat2();
+    case Opcodes::kMONITORENTER:
+      return new Monitor::Enter();
+    case Opcodes::kMONITOREXIT:
+      return new Monitor::Exit();
+    case Opcodes::kMULTIANEWARRAY:
+      return new Misc::MultiDimArray();
+    case Opcodes::kNEW:
+      return new Misc::New();
+    case Opcodes::kNEWARRAY:
+      return new Misc::NewArray();
+    case Opcodes::kPUTFIELD:
+      return new Misc::PutField();
+    case Opcodes::kPUTSTATIC:
+      return new Misc::PutStatic();
+  }
+  return nullptr;
+}
+
+static Instruction *getInstruction(const Utils::Types::u1 &opcode) {
+  static std::unique_ptr<Instruction> instructions[256];
+  if (!instructions[opcode]) {
+    instructions[opcode].reset(createInstruction(opcode));
+  }
+  return instructions[opcode].get();
+}
+
+static inline int readU2(const std::vector<Utils::Types::u1> &code,
+                         const int &pos) {
+  return (code.at(pos) << 8) | code.at(pos + 1);
+}
+
+static inline int readS2(const std::vector<Utils::Types::u1> &code,
+                         const int &pos) {
+  return static_cast<int16_t>(readU2(code, pos));
+}
+
+static inline int readS4(const std::vector<Utils::Types::u1> &code,
+                         const int &pos) {
+  return static_cast<int32_t>((static_cast<Utils::Types::u4>(code.at(pos)) << 24) |
+                              (code.at(pos + 1) << 16) |
+                              (code.at(pos + 2) << 8) | code.at(pos + 3));
+}
+
+static int resolveTarget(const DecodedMethod *method, const int &target_pc) {
+  if (target_pc < 0 ||
+      target_pc >= static_cast<int>(method->index_of_pc.size()) ||
+      method->index_of_pc[target_pc] < 0) {
+    std::stringstream ss;
+    ss << "invalid branch target " << target_pc;
+    throw Utils::Errors::Exception(Utils::Errors::kINSTRUCTION, ss.str());
+  }
+  return method->index_of_pc[target_pc];
+}
+
+DecodedMethod *decodeMethod(Utils::Attributes::Code_attribute *code_attr) {
+  namespace op = Opcodes;
+  auto &code = code_attr->code;
+  auto method = new DecodedMethod();
+  method->bytecode = &code;
+  method->linked = false;
+  method->index_of_pc.assign(code.size(), -1);
+
+  // instruções cujo operando a ainda é um pc, resolvido depois que todo o
+  // código estiver decodificado
+  std::vector<size_t> branches;
+  int size = code.size();
+  for (int pc = 0; pc < size;) {
+    DecodedInstruction insn = {nullptr, code[pc], false, pc, 0, 0};
+    method->index_of_pc[pc] = method->code.size();
+    auto next = pc + 1;
+
+    switch (insn.opcode) {
+      case op::kICONST_M1:
+      case op::kICONST_0:
+      case op::kICONST_1:
+      case op::kICONST_2:
+      case op::kICONST_3:
+      case op::kICONST_4:
+      case op::kICONST_5:
+        insn.a = insn.opcode - op::kICONST_0;
+        break;
+      case op::kLCONST_0:
+      case op::kLCONST_1:
+        insn.a = insn.opcode - op::kLCONST_0;
+        break;
+      case op::kFCONST_0:
+      case op::kFCONST_1:
+      case op::kFCONST_2:
+        insn.a = insn.opcode - op::kFCONST_0;
+        break;
+      case op::kDCONST_0:
+      case op::kDCONST_1:
+        insn.a = insn.opcode - op::kDCONST_0;
+        break;
+      case op::kBIPUSH:
+        insn.a = static_cast<int8_t>(code.at(pc + 1));
+        next = pc + 2;
+        break;
+      case op::kSIPUSH:
+        insn.a = readS2(code, pc + 1);
+        next = pc + 3;
+        break;
+      case op::kILOAD:
+      case op::kLLOAD:
+      case op::kFLOAD:
+      case op::kDLOAD:
+      case op::kALOAD:
+      case op::kISTORE:
+      case op::kLSTORE:
+      case op::kFSTORE:
+      case op::kDSTORE:
+      case op::kASTORE:
+      case op::kRET:
+        insn.a = code.at(pc + 1);
+        next = pc + 2;
+        break;
+      case op::kILOAD_0:
+      case op::kILOAD_1:
+      case op::kILOAD_2:
+      case op::kILOAD_3:
+        insn.a = insn.opcode - op::kILOAD_0;
+        break;
+      case op::kLLOAD_0:
+      case op::kLLOAD_1:
+      case op::kLLOAD_2:
+      case op::kLLOAD_3:
+        insn.a = insn.opcode - op::kLLOAD_0;
+        break;
+      case op::kFLOAD_0:
+      case op::kFLOAD_1:
+      case op::kFLOAD_2:
+      case op::kFLOAD_3:
+        insn.a = insn.opcode - op::kFLOAD_0;
+        break;
+      case op::kDLOAD_0:
+      case op::kDLOAD_1:
+      case op::kDLOAD_2:
+      case op::kDLOAD_3:
+        insn.a = insn.opcode - op::kDLOAD_0;
+        break;
+      case op::kALOAD_0:
+      case op::kALOAD_1:
+      case op::kALOAD_2:
+      case op::kALOAD_3:
+        insn.a = insn.opcode - op::kALOAD_0;
+        break;
+      case op::kISTORE_0:
+      case op::kISTORE_1:
+      case op::kISTORE_2:
+      case op::kISTORE_3:
+        insn.a = insn.opcode - op::kISTORE_0;
+        break;
+      case op::kLSTORE_0:
+      case op::kLSTORE_1:
+      case op::kLSTORE_2:
+      case op::kLSTORE_3:
+        insn.a = insn.opcode - op::kLSTORE_0;
+        break;
+      case op::kFSTORE_0:
+      case op::kFSTORE_1:
+      case op::kFSTORE_2:
+      case op::kFSTORE_3:
+        insn.a = insn.opcode - op::kFSTORE_0;
+        break;
+      case op::kDSTORE_0:
+      case op::kDSTORE_1:
+      case op::kDSTORE_2:
+      case op::kDSTORE_3:
+        insn.a = insn.opcode - op::kDSTORE_0;
+        break;
+      case op::kASTORE_0:
+      case op::kASTORE_1:
+      case op::kASTORE_2:
+      case op::kASTORE_3:
+        insn.a = insn.opcode - op::kASTORE_0;
+        break;
+      case op::kIINC:
+        insn.a = code.at(pc + 1);
+        insn.b = static_cast<int8_t>(code.at(pc + 2));
+        next = pc + 3;
+        break;
+      case op::kWIDE:
+        insn.opcode = code.at(pc + 1);
+        insn.wide = true;
+        insn.a = readU2(code, pc + 2);
+        next = pc + 4;
+        if (insn.opcode == op::kIINC) {
+          insn.b = readS2(code, pc + 4);
+          next = pc + 6;
+        }
+        break;
+      case op::kIFEQ:
+      case op::kIFNE:
+      case op::kIFLT:
+      case op::kIFGE:
+      case op::kIFGT:
+      case op::kIFLE:
+      case op::kIF_ICMPEQ:
+      case op::kIF_ICMPNE:
+      case op::kIF_ICMPLT:
+      case op::kIF_ICMPGE:
+      case op::kIF_ICMPGT:
+      case op::kIF_ICMPLE:
+      case op::kIF_ACMPEQ:
+      case op::kIF_ACMPNE:
+      case op::kIFNULL:
+      case op::kIFNONNULL:
+      case op::kGOTO:
+      case op::kJSR:
+        insn.a = pc + readS2(code, pc + 1);
+        branches.push_back(method->code.size());
+        next = pc + 3;
+        // endereço de retorno do jsr
+        insn.b = next;
+        break;
+      case op::kGOTO_W:
+      case op::kJSR_W:
+        insn.a = pc + readS4(code, pc + 1);
+        branches.push_back(method->code.size());
+        next = pc + 5;
+        insn.b = next;
+        break;
+      case op::kTABLESWITCH: {
+        // os operandos começam no primeiro endereço múltiplo de 4
+        auto pos = (pc + 4) & ~3;
+        SwitchTable table;
+        table.default_target = pc + readS4(code, pos);
+        table.low = readS4(code, pos + 4);
+        auto high = readS4(code, pos + 8);
+        pos += 12;
+        // em 64 bits pra não estourar quando high é INT_MAX ou low é INT_MIN
+        auto count = static_cast<int64_t>(high) - table.low + 1;
+        for (int64_t i = 0; i < count; ++i, pos += 4) {
+          table.targets.push_back(pc + readS4(code, pos));
+        }
+        insn.a = method->switches.size();
+        method->switches.push_back(table);
+        next = pos;
+        break;
+      }
+      case op::kLOOKUPSWITCH: {
+        auto pos = (pc + 4) & ~3;
+        SwitchTable table;
+        table.default_target = pc + readS4(code, pos);
+        table.low = 0;
+        auto npairs = readS4(code, pos + 4);
+        pos += 8;
+        std::vector<std::pair<int, int>> pairs;
+        for (int i = 0; i < npairs; ++i, pos += 8) {
+          pairs.emplace_back(readS4(code, pos), pc + readS4(code, pos + 4));
+        }
+        std::sort(pairs.begin(), pairs.end());
+        for (auto &pair : pairs) {
+          table.keys.push_back(pair.first);
+          table.targets.push_back(pair.second);
+        }
+        insn.a = method->switches.size();
+        method->switches.push_back(table);
+        next = pos;
+        break;
+      }
+      case op::kLDC:
+      case op::kNEWARRAY:
+        next = pc + 2;
+        break;
+      case op::kGETSTATIC:
+      case op::kPUTSTATIC:
+      case op::kGETFIELD:
+      case op::kPUTFIELD:
+        // indice da entrada do field na constant pool
+        insn.a = readU2(code, pc + 1);
+        next = pc + 3;
+        break;
+      case op::kLDC_W:
+      case op::kLDC2_W:
+      case op::kINVOKEVIRTUAL:
+      case op::kINVOKESPECIAL:
+      case op::kINVOKESTATIC:
+      case op::kNEW:
+      case op::kANEWARRAY:
+      case op::kCHECKCAST:
+      case op::kINSTANCEOF:
+        next = pc + 3;
+        break;
+      case op::kMULTIANEWARRAY:
+        next = pc + 4;
+        break;
+      case op::kINVOKEINTERFACE:
+      case op::kINVOKEDYNAMIC:
+        next = pc + 5;
+        break;
+    }
+    method->code.push_back(insn);
+    pc = next;
+  }
+
+  for (auto i : branches) {
+    method->code[i].a = resolveTarget(method, method->code[i].a);
+  }
+  for (auto &table : method->switches) {
+    table.default_target = resolveTarget(method, table.default_target);
+    for (auto &target : table.targets) {
+      target = resolveTarget(method, target);
+    }
+  }
+  return method;
+}
+
+#if defined(__GNUC__)
+// computed goto (&&label e goto *ptr) é uma extensão do GCC/Clang
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define DISPATCH() goto *ip->handler
+#define NEXT() \
+  do {         \
+    ++ip;      \
+    DISPATCH(); \
+  } while (0)
+#define JUMP(target)       \
+  do {                     \
+    ip = base + (target);  \
+    DISPATCH();            \
+  } while (0)
+#define BRANCH_IF(cond) \
+  do {                  \
+    if (cond) {         \
+      JUMP(ip->a);      \
+    }                   \
+    NEXT();             \
+  } while (0)
+// operação de dois operandos do tipo T, val1 e val2
+#define BINARY(T, result)               \
+  do {                                  \
+    auto val2 = frame->popOperand<T>(); \
+    auto val1 = frame->popOperand<T>(); \
+    frame->pushOperand<T>(result);      \
+    NEXT();                             \
+  } while (0)
+#define CONVERT(From, To, result)           \
+  do {                                      \
+    auto value = frame->popOperand<From>(); \
+    frame->pushOperand<To>(result);         \
+    NEXT();                                 \
+  } while (0)
+// lcmp, fcmp e dcmp. Com NaN nenhuma comparação é verdadeira, o resultado é
+// o da variante da instrução
+#define COMPARE(T, unordered)                              \
+  do {                                                     \
+    auto val2 = frame->popOperand<T>();                    \
+    auto val1 = frame->popOperand<T>();                    \
+    frame->pushOperand<int>(val1 > val2    ? 1             \
+                            : val1 == val2 ? 0             \
+                            : val1 < val2  ? -1            \
+                                           : (unordered)); \
+    NEXT();                                                \
+  } while (0)
+// o pc do frame é o da instrução caso o getArray lance a exceção
+#define ARRAY_LOAD(Element, Pushed)                            \
+  do {                                                         \
+    auto index = frame->popOperand<int>();                     \
+    auto arrayobj = frame->popOperand<Utils::Object *>();      \
+    frame->pc = ip->pc;                                        \
+    auto arrayref = th->getArray(arrayobj, index);             \
+    if (!arrayref) {                                           \
+      return;                                                  \
+    }                                                          \
+    frame->pushOperand<Pushed>(arrayref->get<Element>(index)); \
+    NEXT();                                                    \
+  } while (0)
+#define ARRAY_STORE(Element, Popped)                                \
+  do {                                                              \
+    auto value = static_cast<Element>(frame->popOperand<Popped>()); \
+    auto index = frame->popOperand<int>();                          \
+    auto arrayobj = frame->popOperand<Utils::Object *>();           \
+    frame->pc = ip->pc;                                             \
+    auto arrayref = th->getArray(arrayobj, index);                  \
+    if (!arrayref) {                                                \
+      return;                                                       \
+    }                                                               \
+    arrayref->insert(value, index);                                 \
+    NEXT();                                                         \
+  } while (0)
+
+void runDecoded(DecodedMethod *method, MemoryAreas::Thread *th,
+                const int &start) {
+  namespace op = Opcodes;
+  static const void *labels[256];
+  static bool labels_ready = false;
+  if (!labels_ready) {
+    for (auto &label : labels) {
+      label = &&fallback;
+    }
+    labels[op::kNOP] = &&nop;
+    labels[op::kACONST_NULL] = &&aconst_null;
+    for (auto o : {op::kICONST_M1, op::kICONST_0, op::kICONST_1, op::kICONST_2,
+                   op::kICONST_3, op::kICONST_4, op::kICONST_5, op::kBIPUSH,
+                   op::kSIPUSH}) {
+      labels[o] = &&iconst;
+    }
+    labels[op::kLCONST_0] = labels[op::kLCONST_1] = &&lconst;
+    labels[op::kFCONST_0] = labels[op::kFCONST_1] = labels[op::kFCONST_2] =
+        &&fconst;
+    labels[op::kDCONST_0] = labels[op::kDCONST_1] = &&dconst;
+    for (int i = 0; i < 4; ++i) {
+      labels[op::kILOAD_0 + i] = &&iload;
+      labels[op::kLLOAD_0 + i] = &&lload;
+      labels[op::kFLOAD_0 + i] = &&fload;
+      labels[op::kDLOAD_0 + i] = &&dload;
+      labels[op::kALOAD_0 + i] = &&aload;
+      labels[op::kISTORE_0 + i] = &&istore;
+      labels[op::kLSTORE_0 + i] = &&lstore;
+      labels[op::kFSTORE_0 + i] = &&fstore;
+      labels[op::kDSTORE_0 + i] = &&dstore;
+      labels[op::kASTORE_0 + i] = &&astore;
+    }
+    labels[op::kILOAD] = &&iload;
+    labels[op::kLLOAD] = &&lload;
+    labels[op::kFLOAD] = &&fload;
+    labels[op::kDLOAD] = &&dload;
+    labels[op::kALOAD] = &&aload;
+    labels[op::kISTORE] = &&istore;
+    labels[op::kLSTORE] = &&lstore;
+    labels[op::kFSTORE] = &&fstore;
+    labels[op::kDSTORE] = &&dstore;
+    labels[op::kASTORE] = &&astore;
+    labels[op::kIINC] = &&iinc;
+    labels[op::kIADD] = &&iadd;
+    labels[op::kISUB] = &&isub;
+    labels[op::kIMUL] = &&imul;
+    labels[op::kIDIV] = &&idiv;
+    labels[op::kIREM] = &&irem;
+    labels[op::kINEG] = &&ineg;
+    labels[op::kISHL] = &&ishl;
+    labels[op::kISHR] = &&ishr;
+    labels[op::kIUSHR] = &&iushr;
+    labels[op::kIAND] = &&iand;
+    labels[op::kIOR] = &&ior;
+    labels[op::kIXOR] = &&ixor;
+    labels[op::kIFEQ] = &&ifeq;
+    labels[op::kIFNE] = &&ifne;
+    labels[op::kIFLT] = &&iflt;
+    labels[op::kIFGE] = &&ifge;
+    labels[op::kIFGT] = &&ifgt;
+    labels[op::kIFLE] = &&ifle;
+    labels[op::kIF_ICMPEQ] = &&if_icmpeq;
+    labels[op::kIF_ICMPNE] = &&if_icmpne;
+    labels[op::kIF_ICMPLT] = &&if_icmplt;
+    labels[op::kIF_ICMPGE] = &&if_icmpge;
+    labels[op::kIF_ICMPGT] = &&if_icmpgt;
+    labels[op::kIF_ICMPLE] = &&if_icmple;
+    labels[op::kIF_ACMPEQ] = &&if_acmpeq;
+    labels[op::kIF_ACMPNE] = &&if_acmpne;
+    labels[op::kIFNULL] = &&ifnull;
+    labels[op::kIFNONNULL] = &&ifnonnull;
+    labels[op::kGOTO] = labels[op::kGOTO_W] = &&goto_;
+    labels[op::kJSR] = labels[op::kJSR_W] = &&jsr;
+    labels[op::kRET] = &&ret;
+    labels[op::kTABLESWITCH] = &&tableswitch;
+    labels[op::kLOOKUPSWITCH] = &&lookupswitch;
+    labels[op::kIRETURN] = &&ireturn;
+    labels[op::kLRETURN] = &&lreturn;
+    labels[op::kFRETURN] = &&freturn;
+    labels[op::kDRETURN] = &&dreturn;
+    labels[op::kARETURN] = &&areturn;
+    labels[op::kRETURN] = &&return_;
+    labels[op::kLADD] = &&ladd;
+    labels[op::kLSUB] = &&lsub;
+    labels[op::kLMUL] = &&lmul;
+    labels[op::kLDIV] = &&ldiv;
+    labels[op::kLREM] = &&lrem;
+    labels[op::kLNEG] = &&lneg;
+    labels[op::kLSHL] = &&lshl;
+    labels[op::kLSHR] = &&lshr;
+    labels[op::kLUSHR] = &&lushr;
+    labels[op::kLAND] = &&land;
+    labels[op::kLOR] = &&lor;
+    labels[op::kLXOR] = &&lxor;
+    labels[op::kLCMP] = &&lcmp;
+    labels[op::kFADD] = &&fadd;
+    labels[op::kFSUB] = &&fsub;
+    labels[op::kFMUL] = &&fmul;
+    labels[op::kFDIV] = &&fdiv;
+    labels[op::kFREM] = &&frem;
+    labels[op::kFNEG] = &&fneg;
+    labels[op::kFCMPL] = &&fcmpl;
+    labels[op::kFCMPG] = &&fcmpg;
+    labels[op::kDADD] = &&dadd;
+    labels[op::kDSUB] = &&dsub;
+    labels[op::kDMUL] = &&dmul;
+    labels[op::kDDIV] = &&ddiv;
+    labels[op::kDREM] = &&drem;
+    labels[op::kDNEG] = &&dneg;
+    labels[op::kDCMPL] = &&dcmpl;
+    labels[op::kDCMPG] = &&dcmpg;
+    labels[op::kI2L] = &&i2l;
+    labels[op::kI2F] = &&i2f;
+    labels[op::kI2D] = &&i2d;
+    labels[op::kL2I] = &&l2i;
+    labels[op::kL2F] = &&l2f;
+    labels[op::kL2D] = &&l2d;
+    labels[op::kF2I] = &&f2i;
+    labels[op::kF2L] = &&f2l;
+    labels[op::kF2D] = &&f2d;
+    labels[op::kD2I] = &&d2i;
+    labels[op::kD2L] = &&d2l;
+    labels[op::kD2F] = &&d2f;
+    labels[op::kI2B] = &&i2b;
+    labels[op::kI2C] = &&i2c;
+    labels[op::kI2S] = &&i2s;
+    labels[op::kIALOAD] = &&iaload;
+    labels[op::kLALOAD] = &&laload;
+    labels[op::kFALOAD] = &&faload;
+    labels[op::kDALOAD] = &&daload;
+    labels[op::kAALOAD] = &&aaload;
+    labels[op::kBALOAD] = &&baload;
+    labels[op::kCALOAD] = &&caload;
+    labels[op::kSALOAD] = &&saload;
+    labels[op::kIASTORE] = &&iastore;
+    labels[op::kLASTORE] = &&lastore;
+    labels[op::kFASTORE] = &&fastore;
+    labels[op::kDASTORE] = &&dastore;
+    labels[op::kAASTORE] = &&aastore;
+    labels[op::kBASTORE] = &&bastore;
+    labels[op::kCASTORE] = &&castore;
+    labels[op::kSASTORE] = &&sastore;
+    labels[op::kARRAYLENGTH] = &&arraylength;
+    labels[op::kGETFIELD] = &&getfield;
+    labels[op::kPUTFIELD] = &&putfield;
+    labels[op::kGETSTATIC] = &&getstatic;
+    labels[op::kPUTSTATIC] = &&putstatic;
+    labels[op::kPOP] = &&pop;
+    labels[op::kPOP2] = &&pop2;
+    labels[op::kDUP] = &&dup;
+    labels[op::kDUP_X1] = &&dup_x1;
+    labels[op::kDUP_X2] = &&dup_x2;
+    labels[op::kDUP2] = &&dup2;
+    labels[op::kDUP2_X1] = &&dup2_x1;
+    labels[op::kDUP2_X2] = &&dup2_x2;
+    labels[op::kSWAP] = &&swap;
+    labels_ready = true;
+  }
+
+  if (!method->linked) {
+    for (auto &insn : method->code) {
+      insn.handler =
+          Utils::Flags::options.kDEBUG ? &&trace : labels[insn.opcode];
+    }
+    method->linked = true;
+  }
+
+  auto frame = th->current_frame;
+  auto runtime_class = frame->getRuntimeClass();
+  auto base = method->code.data();
+  auto ip = base + start;
+  DISPATCH();
+
+trace:
+  std::cout << ip->pc << ": ";
+  // as instruções do fallback já imprimem a si mesmas no modo debug
+  if (labels[ip->opcode] != &&fallback) {
+    std::cout << "Executando " << Opcodes::getMnemonic(ip->opcode) << "\n";
+  }
+  goto *labels[ip->opcode];
+
+nop:
+  NEXT();
+
+aconst_null:
+  frame->pushOperand<Utils::Object>(nullptr);
+  NEXT();
+
+iconst:
+  frame->pushOperand<int>(ip->a);
+  NEXT();
+
+lconst:
+  frame->pushOperand<long>(ip->a);
+  NEXT();
+
+fconst:
+  frame->pushOperand<float>(ip->a);
+  NEXT();
+
+dconst:
+  frame->pushOperand<double>(ip->a);
+  NEXT();
+
+iload:
+  frame->pushOperand(frame->getLocalVarValue<int>(ip->a));
+  NEXT();
+
+lload:
+  frame->pushOperand(frame->getLocalVarValue<long>(ip->a));
+  NEXT();
+
+fload:
+  frame->pushOperand(frame->getLocalVarValue<float>(ip->a));
+  NEXT();
+
+dload:
+  frame->pushOperand(frame->getLocalVarValue<double>(ip->a));
+  NEXT();
+
+aload:
+  frame->pushOperand(frame->getLocalVarValue<Utils::Object *>(ip->a));
+  NEXT();
+
+istore:
+  frame->pushLocalVar(frame->popOperand<int>(), ip->a);
+  NEXT();
+
+lstore:
+  frame->pushLocalVar(frame->popOperand<long>(), ip->a);
+  NEXT();
+
+fstore:
+  frame->pushLocalVar(frame->popOperand<float>(), ip->a);
+  NEXT();
+
+dstore:
+  frame->pushLocalVar(frame->popOperand<double>(), ip->a);
+  NEXT();
+
+astore:
+  frame->pushLocalVar(frame->popOperand<Utils::Object *>(), ip->a);
+  NEXT();
+
+iinc:
+  *frame->getLocalVarReference<int>(ip->a) += ip->b;
+  NEXT();
+
+iadd : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(static_cast<Utils::Types::u4>(val1) + val2);
+  NEXT();
+}
+
+isub : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(static_cast<Utils::Types::u4>(val1) - val2);
+  NEXT();
+}
+
+imul : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(static_cast<Utils::Types::u4>(val1) * val2);
+  NEXT();
+}
+
+idiv : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  if (!val2) {
+    // o handler é procurado com o pc da instrução que lançou
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return;
+  }
+  // INT_MIN / -1 estoura no hardware, em java o resultado é o próprio INT_MIN
+  frame->pushOperand<int>(val2 == -1 ? 0u - static_cast<Utils::Types::u4>(val1)
+                                     : val1 / val2);
+  NEXT();
+}
+
+irem : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  if (!val2) {
+    // o handler é procurado com o pc da instrução que lançou
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return;
+  }
+  frame->pushOperand<int>(val2 == -1 ? 0 : val1 % val2);
+  NEXT();
+}
+
+ineg:
+  frame->pushOperand<int>(0u - static_cast<Utils::Types::u4>(
+                                   frame->popOperand<int>()));
+  NEXT();
+
+ishl : {
+  auto s = frame->popOperand<int>() & 0x1F;
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(static_cast<Utils::Types::u4>(val1) << s);
+  NEXT();
+}
+
+ishr : {
+  auto s = frame->popOperand<int>() & 0x1F;
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(val1 >> s);
+  NEXT();
+}
+
+iushr : {
+  auto s = frame->popOperand<int>() & 0x1F;
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(static_cast<Utils::Types::u4>(val1) >> s);
+  NEXT();
+}
+
+iand : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(val1 & val2);
+  NEXT();
+}
+
+ior : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(val1 | val2);
+  NEXT();
+}
+
+ixor : {
+  auto val2 = frame->popOperand<int>();
+  auto val1 = frame->popOperand<int>();
+  frame->pushOperand<int>(val1 ^ val2);
+  NEXT();
+}
+
+ifeq:
+  BRANCH_IF(frame->popOperand<int>() == 0);
+
+ifne:
+  BRANCH_IF(frame->popOperand<int>() != 0);
+
+iflt:
+  BRANCH_IF(frame->popOperand<int>() < 0);
+
+ifge:
+  BRANCH_IF(frame->popOperand<int>() >= 0);
+
+ifgt:
+  BRANCH_IF(frame->popOperand<int>() > 0);
+
+ifle:
+  BRANCH_IF(frame->popOperand<int>() <= 0);
+
+if_icmpeq : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() == val2);
+}
+
+if_icmpne : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() != val2);
+}
+
+if_icmplt : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() < val2);
+}
+
+if_icmpge : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() >= val2);
+}
+
+if_icmpgt : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() > val2);
+}
+
+if_icmple : {
+  auto val2 = frame->popOperand<int>();
+  BRANCH_IF(frame->popOperand<int>() <= val2);
+}
+
+if_acmpeq : {
+  auto val2 = frame->popOperand<Utils::Object *>();
+  BRANCH_IF(frame->popOperand<Utils::Object *>() == val2);
+}
+
+if_acmpne : {
+  auto val2 = frame->popOperand<Utils::Object *>();
+  BRANCH_IF(frame->popOperand<Utils::Object *>() != val2);
+}
+
+ifnull:
+  BRANCH_IF(frame->popOperand<Utils::Object *>() == nullptr);
+
+ifnonnull:
+  BRANCH_IF(frame->popOperand<Utils::Object *>() != nullptr);
+
+goto_:
+  JUMP(ip->a);
+
+jsr:
+  // o endereço de retorno fica como pc, igual no bytecode original
+  frame->pushOperand<int>(ip->b);
+  JUMP(ip->a);
+
+ret:
+  JUMP(resolveTarget(method, frame->getLocalVarValue<int>(ip->a)));
+
+tableswitch : {
+  auto &table = method->switches[ip->a];
+  auto offset = static_cast<int64_t>(frame->popOperand<int>()) - table.low;
+  if (offset < 0 || offset >= static_cast<int64_t>(table.targets.size())) {
+    JUMP(table.default_target);
+  }
+  JUMP(table.targets[offset]);
+}
+
+lookupswitch : {
+  auto &table = method->switches[ip->a];
+  auto key = frame->popOperand<int>();
+  auto match = std::lower_bound(table.keys.begin(), table.keys.end(), key);
+  if (match == table.keys.end() || *match != key) {
+    JUMP(table.default_target);
+  }
+  JUMP(table.targets[match - table.keys.begin()]);
+}
+
+ireturn:
+  th->pushReturnValue(frame->popOperand<int>());
+  frame->cleanOperands();
+  return;
+
+lreturn:
+  th->pushReturnValue(frame->popOperand<long>());
+  frame->cleanOperands();
+  return;
+
+freturn:
+  th->pushReturnValue(frame->popOperand<float>());
+  frame->cleanOperands();
+  return;
+
+dreturn:
+  th->pushReturnValue(frame->popOperand<double>());
+  frame->cleanOperands();
+  return;
+
+areturn:
+  th->pushReturnValue(frame->popOperand<Utils::Object *>());
+  frame->cleanOperands();
+  return;
+
+return_:
+  frame->cleanOperands();
+  return;
+
+ladd:
+  BINARY(long, static_cast<Utils::Types::u8>(val1) + val2);
+
+lsub:
+  BINARY(long, static_cast<Utils::Types::u8>(val1) - val2);
+
+lmul:
+  BINARY(long, static_cast<Utils::Types::u8>(val1) * val2);
+
+ldiv : {
+  auto val2 = frame->popOperand<long>();
+  auto val1 = frame->popOperand<long>();
+  if (!val2) {
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return;
+  }
+  // LONG_MIN / -1 é LONG_MIN, como no idiv
+  frame->pushOperand<long>(val2 == -1
+                               ? 0u - static_cast<Utils::Types::u8>(val1)
+                               : val1 / val2);
+  NEXT();
+}
+
+lrem : {
+  auto val2 = frame->popOperand<long>();
+  auto val1 = frame->popOperand<long>();
+  if (!val2) {
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/ArithmeticException", "/ by zero");
+    return;
+  }
+  frame->pushOperand<long>(val2 == -1 ? 0 : val1 % val2);
+  NEXT();
+}
+
+lneg:
+  frame->pushOperand<long>(0u - static_cast<Utils::Types::u8>(
+                                    frame->popOperand<long>()));
+  NEXT();
+
+lshl : {
+  auto s = frame->popOperand<int>() & 0x3F;
+  auto val1 = frame->popOperand<long>();
+  frame->pushOperand<long>(static_cast<Utils::Types::u8>(val1) << s);
+  NEXT();
+}
+
+lshr : {
+  auto s = frame->popOperand<int>() & 0x3F;
+  auto val1 = frame->popOperand<long>();
+  frame->pushOperand<long>(val1 >> s);
+  NEXT();
+}
+
+lushr : {
+  auto s = frame->popOperand<int>() & 0x3F;
+  auto val1 = frame->popOperand<long>();
+  frame->pushOperand<long>(static_cast<Utils::Types::u8>(val1) >> s);
+  NEXT();
+}
+
+land:
+  BINARY(long, val1 & val2);
+
+lor:
+  BINARY(long, val1 | val2);
+
+lxor:
+  BINARY(long, val1 ^ val2);
+
+lcmp:
+  COMPARE(long, 0);
+
+fadd:
+  BINARY(float, val1 + val2);
+
+fsub:
+  BINARY(float, val1 - val2);
+
+fmul:
+  BINARY(float, val1 * val2);
+
+fdiv:
+  BINARY(float, val1 / val2);
+
+frem:
+  BINARY(float, std::fmod(val1, val2));
+
+fneg:
+  frame->pushOperand<float>(-frame->popOperand<float>());
+  NEXT();
+
+fcmpl:
+  COMPARE(float, -1);
+
+fcmpg:
+  COMPARE(float, 1);
+
+dadd:
+  BINARY(double, val1 + val2);
+
+dsub:
+  BINARY(double, val1 - val2);
+
+dmul:
+  BINARY(double, val1 * val2);
+
+ddiv:
+  BINARY(double, val1 / val2);
+
+drem:
+  BINARY(double, std::fmod(val1, val2));
+
+dneg:
+  frame->pushOperand<double>(-frame->popOperand<double>());
+  NEXT();
+
+dcmpl:
+  COMPARE(double, -1);
+
+dcmpg:
+  COMPARE(double, 1);
+
+i2l:
+  CONVERT(int, long, value);
+
+i2f:
+  CONVERT(int, float, value);
+
+i2d:
+  CONVERT(int, double, value);
+
+l2i:
+  CONVERT(long, int, static_cast<Utils::Types::u4>(value));
+
+l2f:
+  CONVERT(long, float, value);
+
+l2d:
+  CONVERT(long, double, value);
+
+f2i:
+  CONVERT(float, int, Utils::toIntegral<int>(value));
+
+f2l:
+  CONVERT(float, long, Utils::toIntegral<long>(value));
+
+f2d:
+  CONVERT(float, double, value);
+
+d2i:
+  CONVERT(double, int, Utils::toIntegral<int>(value));
+
+d2l:
+  CONVERT(double, long, Utils::toIntegral<long>(value));
+
+d2f:
+  CONVERT(double, float, value);
+
+i2b:
+  CONVERT(int, int, static_cast<int8_t>(value));
+
+i2c:
+  CONVERT(int, int, static_cast<uint16_t>(value));
+
+i2s:
+  CONVERT(int, int, static_cast<int16_t>(value));
+
+iaload:
+  ARRAY_LOAD(int, int);
+
+laload:
+  ARRAY_LOAD(long, long);
+
+faload:
+  ARRAY_LOAD(float, float);
+
+daload:
+  ARRAY_LOAD(double, double);
+
+aaload:
+  ARRAY_LOAD(Utils::Object *, Utils::Object *);
+
+baload:
+  ARRAY_LOAD(int8_t, int);
+
+caload:
+  ARRAY_LOAD(uint16_t, int);
+
+saload:
+  ARRAY_LOAD(int16_t, int);
+
+iastore:
+  ARRAY_STORE(int, int);
+
+lastore:
+  ARRAY_STORE(long, long);
+
+fastore:
+  ARRAY_STORE(float, float);
+
+dastore:
+  ARRAY_STORE(double, double);
+
+bastore:
+  ARRAY_STORE(int8_t, int);
+
+castore:
+  ARRAY_STORE(uint16_t, int);
+
+sastore:
+  ARRAY_STORE(int16_t, int);
+
+aastore : {
+  auto value = frame->popOperand<Utils::Object *>();
+  auto index = frame->popOperand<int>();
+  auto arrayobj = frame->popOperand<Utils::Object *>();
+  frame->pc = ip->pc;
+  auto arrayref = th->getArray(arrayobj, index);
+  if (!arrayref) {
+    return;
+  }
+  auto old_value = arrayref->get<Utils::Object *>(index);
+  arrayref->insert(value, index);
+  th->heap->writeBarrier(arrayobj, old_value, value);
+  NEXT();
+}
+
+arraylength : {
+  auto objectref = frame->popOperand<Utils::Object *>();
+  if (!objectref) {
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  frame->pushOperand<int>(objectref->data.as<Utils::Array_t *>()->length());
+  NEXT();
+}
+
+// os fields só são acessados aqui depois que a entrada foi resolvida. A
+// primeira execução, que resolve a entrada e inicializa a classe, e os erros
+// de linkagem ficam com o fallback
+getfield : {
+  auto ref = runtime_class->getFieldRef(ip->a);
+  if (!ref->resolved || ref->is_static) {
+    goto fallback;
+  }
+  auto objectref = frame->popOperand<Utils::Object *>();
+  if (!objectref) {
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  frame->pushOperand(objectref->getFields()[ref->slot]);
+  NEXT();
+}
+
+putfield : {
+  auto ref = runtime_class->getFieldRef(ip->a);
+  if (!ref->resolved || ref->is_static) {
+    goto fallback;
+  }
+  auto val = frame->popOperand<Utils::Slot>();
+  auto objectref = frame->popOperand<Utils::Object *>();
+  if (!objectref) {
+    frame->pc = ip->pc;
+    th->throwNewException("java/lang/NullPointerException");
+    return;
+  }
+  auto &field = objectref->getFields()[ref->slot];
+  th->heap->writeBarrier(objectref, field, val);
+  field = val;
+  NEXT();
+}
+
+getstatic : {
+  // System.out não tem statics e continua com o fallback
+  auto ref = runtime_class->getFieldRef(ip->a);
+  if (!ref->statics || !ref->is_static) {
+    goto fallback;
+  }
+  frame->pushOperand(ref->statics->fields[ref->slot]);
+  NEXT();
+}
+
+putstatic : {
+  auto ref = runtime_class->getFieldRef(ip->a);
+  if (!ref->statics || !ref->is_static) {
+    goto fallback;
+  }
+  auto val = frame->popOperand<Utils::Slot>();
+  auto &field = ref->statics->fields[ref->slot];
+  th->heap->writeBarrier(ref->statics, field, val);
+  field = val;
+  NEXT();
+}
+
+// dup, pop e swap movem os slots crus, long e double são dois slots
+pop:
+  frame->popSlot();
+  NEXT();
+
+pop2:
+  frame->popSlot();
+  frame->popSlot();
+  NEXT();
+
+dup : {
+  auto val = frame->topOperand();
+  frame->pushSlot(val);
+  NEXT();
+}
+
+dup_x1 : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  frame->pushSlot(val1);
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  NEXT();
+}
+
+dup_x2 : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  auto val3 = frame->popSlot();
+  frame->pushSlot(val1);
+  frame->pushSlot(val3);
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  NEXT();
+}
+
+dup2 : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  NEXT();
+}
+
+dup2_x1 : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  auto val3 = frame->popSlot();
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  frame->pushSlot(val3);
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  NEXT();
+}
+
+dup2_x2 : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  auto val3 = frame->popSlot();
+  auto val4 = frame->popSlot();
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  frame->pushSlot(val4);
+  frame->pushSlot(val3);
+  frame->pushSlot(val2);
+  frame->pushSlot(val1);
+  NEXT();
+}
+
+swap : {
+  auto val1 = frame->popSlot();
+  auto val2 = frame->popSlot();
+  frame->pushSlot(val1);
+  frame->pushSlot(val2);
+  NEXT();
+}
+
+fallback : {
+  auto instruction = getInstruction(ip->opcode);
+  if (!instruction) {
+    throw Utils::Errors::Exception(
+        Utils::Errors::kINSTRUCTION,
+        Opcodes::getMnemonic(ip->opcode) +
+            " should not appear in any class file");
+  }
+  // o pc do frame é usado na busca da tabela de exceções
+  frame->pc = ip->pc;
+  auto code_it = method->bytecode->begin() + ip->pc + (ip->wide ? 1 : 0);
+  auto pc = ip->pc;
+  auto delta_code = 0;
+  instruction->execute(&code_it, th, &delta_code, ip->wide, &pc);
+  if (th->pending_exception) {
+    // o handler é procurado pela thread, que recomeça o metodo nele
+    return;
+  }
+  NEXT();
+}
+}
+
+#undef ARRAY_STORE
+#undef ARRAY_LOAD
+#undef COMPARE
+#undef CONVERT
+#undef BINARY
+#undef BRANCH_IF
+#undef JUMP
+#undef NEXT
+#undef DISPATCH
+#pragma GCC diagnostic pop
+#else
+void runDecoded(DecodedMethod *method, MemoryAreas::Thread *th,
+                const int &start) {
+  throw Utils::Errors::Exception(
+      Utils::Errors::kNOTIMPLEMENTED,
+      "the threaded interpreter requires a compiler with computed goto");
+}
+#endif
+}  // namespace Instructions
@@ -1,13 +1,94 @@
 #include "interpreter.h"
 
+#include <pthread.h>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+#include "utils/errors.h"
+#include "utils/fileSystem.h"
 #include "utils/flags.h"
+#include "utils/memory_areas/allocation_profiler.h"
 #include "utils/memory_areas/thread.h"
+#include "utils/throwable_t.h"
+
+// uma exceção que sai do main (ou do <clinit> da classe) encerra a jvm
+static void checkUncaught(MemoryAreas::Thread *th) {
+  if (!th->pending_exception) {
+    return;
+  }
+  auto trace = Utils::getStackTraceText(th->pending_exception);
+  trace.pop_back();
+  th->pending_exception = nullptr;
+  throw Utils::Errors::Exception(Utils::Errors::kUNCAUGHT,
+                                 "Exception in thread \"main\" " + trace);
+}
+
+// cada frame java custa alguns KB de pilha nativa, já que as chamadas
+// recursam pelo runMethod do engine, então a pilha da thread que interpreta
+// acompanha o -Xss em vez de ficar no limite do processo
+static const size_t kNATIVE_STACK_PER_JAVA_STACK = 64;
+static const size_t kMAX_NATIVE_STACK = 1024 * 1024 * 1024;
+static const size_t kMIN_NATIVE_STACK = 8 * 1024 * 1024;
+
+struct NativeTask {
+  std::function<void()> body;
+  std::exception_ptr error;
+};
+
+static void *runNativeTask(void *arg) {
+  auto task = static_cast<NativeTask *>(arg);
+  try {
+    task->body();
+  } catch (...) {
+    task->error = std::current_exception();
+  }
+  return nullptr;
+}
+
+static void runOnInterpreterStack(const std::function<void()> &body) {
+  auto stack_size =
+      std::max(kMIN_NATIVE_STACK,
+               std::min(Utils::Flags::options.kSTACK_SIZE *
+                            kNATIVE_STACK_PER_JAVA_STACK,
+                        kMAX_NATIVE_STACK));
+  NativeTask task{body, nullptr};
+  pthread_attr_t attr;
+  pthread_t native;
+  pthread_attr_init(&attr);
+  auto failed = pthread_attr_setstacksize(&attr, stack_size) ||
+                pthread_create(&native, &attr, runNativeTask, &task);
+  pthread_attr_destroy(&attr);
+  if (failed) {
+    // sem a thread o limite do runMethod continua valendo pra pilha atual
+    body();
+    return;
+  }
+  pthread_join(native, nullptr);
+  if (task.error) {
+    std::rethrow_exception(task.error);
+  }
+}
 
 void Interpreter::run() {
+  // o construtor da thread da jvm mede a pilha nativa de quem o chama, então
+  // o init também precisa rodar na thread nova
+  runOnInterpreterStack([this]() {
+    this->init();
+    this->execute();
+  });
+}
+
+void Interpreter::execute() {
   if (Utils::Flags::options.kVERBOSE) {
     std::cout << "\n\tInterpreting ClassFile " << this->classname << "\n\n";
   }
   threads[0].executeMethod("main", "([Ljava/lang/String;)V");
+  checkUncaught(&threads[0]);
 }
 
 void Interpreter::init() {
@@ -15,15 +96,33 @@ void Interpreter::init() {
     std::cout << "criando as coisas pra thread...\n";
   }
   auto this_class = Utils::getClassName(this->entry_class);
-  this->method_area = new MemoryAreas::MethodArea(this->entry_class);
-  this->method_area->loadClass(this_class);
+  this->classes = new MemoryAreas::ClassRegistry();
+  this->method_area =
+      new MemoryAreas::MethodArea(this->classes, this->entry_class);
 
-  this->heap = new MemoryAreas::Heap();
+  this->heap = new MemoryAreas::Heap(this->classes);
   this->threads.emplace_back(this->method_area, this->heap, this->entry_class);
+  this->heap->addThread(&this->threads[0]);
   try {
     threads[0].method_area->getMethod("<clinit>", "()V");
     this->heap->addClass(&this->threads[0], this_class);
     threads[0].changeContext(this_class, "<clinit>", "()V", false);
   } catch (const Utils::Errors::Exception &e) {
   }
+  checkUncaught(&threads[0]);
+}
+
+void Interpreter::reportAllocations() {
+  MemoryAreas::AllocationProfiler profiler;
+  for (auto &thread : this->threads) {
+    profiler.merge(thread.getProfiler());
+  }
+  profiler.report(std::cerr);
+
+  const std::string outdir = "./.out/";
+  Utils::FileSystem::makeDirectory(outdir.c_str());
+  const std::string classname =
+      this->classname.substr(0, this->classname.find_last_of('.'));
+  std::ofstream o(outdir + classname + "_allocations.json");
+  o << std::setw(2) << profiler.toJson() << std::endl;
 }
@@ -1,5 +1,6 @@
 #include <locale.h>
 
+#include <fstream>
 #include <iostream>
 
 #include "classfile.h"
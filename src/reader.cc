@@ -1,5 +1,6 @@
 #include "reader.h"
 
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -10,6 +11,7 @@
 #include "utils/flags.h"
 #include "utils/infos.h"
 #include "utils/string.h"
+#include "utils/symbol_table.h"
 #include "utils/versions.h"
 
 Reader::Reader(ClassFile *cf, const std::string &fpath) {
@@ -30,13 +32,30 @@ Reader::Reader(ClassFile *cf, const std::string &fpath) {
   }
   this->path = p.substr(0, p.find_last_of("/\\") + 1);
 
-  this->file.open(p, std::ios::binary | std::ios::in);
+  std::ifstream file(p, std::ios::binary | std::ios::ate);
 
-  if (!this->file.is_open()) {
+  if (!file.is_open()) {
     throw Utils::Errors::Exception(
         Utils::Errors::kCLASSFILE,
         "classfile: " + this->fname + " cannot be opened.");
   }
+  // o parser decodifica os campos a partir do buffer, sem voltar no arquivo
+  auto size = file.tellg();
+  if (size < 0) {
+    throw Utils::Errors::Exception(
+        Utils::Errors::kCLASSFILE,
+        "classfile: " + this->fname + " cannot be read.");
+  }
+  this->buffer.resize(static_cast<size_t>(size));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(this->buffer.data()),
+            this->buffer.size());
+  if (!file) {
+    throw Utils::Errors::Exception(
+        Utils::Errors::kCLASSFILE,
+        "classfile: " + this->fname + " cannot be read.");
+  }
+  this->position = 0;
   if (Utils::Flags::options.kVERBOSE) {
     std::cout << "classfile: '" << this->fname << "' opened\n";
   }
@@ -213,6 +232,8 @@ void Reader::readConstantPoolInfo() {
             throw Utils::Errors::Exception(Utils::Errors::kUTF8, err.str());
           }
         }
+        kutf8_info->symbol = Utils::SymbolTable::intern(
+            Utils::String::getUtf8Modified(kutf8_info));
         break;
       }
       case cp::kCONSTANT_METHODHANDLE: {
@@ -419,7 +440,7 @@ void Reader::readAttributesInfo(
 
     this->readBytes(&attrlen);
 
-    auto attrName = Utils::String::getUtf8Modified(kutf8);
+    auto &attrName = kutf8->getValue();
     auto attrtype = Utils::Attributes::getAttributeType(attrName);
 
     switch (attrtype) {
@@ -445,10 +466,7 @@ void Reader::readAttributesInfo(
               "The value of code_length must be greater than zero and less "
               "than 65536.");
         }
-        code_attr->code.resize(code_attr->code_length);
-        for (size_t i = 0; i < code_attr->code_length; ++i) {
-          this->readBytes(&code_attr->code[i], false);
-        }
+        this->readBytes(&code_attr->code, code_attr->code_length);
 
         this->readBytes(&code_attr->exception_table_length);
         code_attr->exception_table.resize(code_attr->exception_table_length);
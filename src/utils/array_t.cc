@@ -4,33 +4,98 @@
 #include "utils/object.h"
 
 namespace Utils {
-// Array_t::~Array_t() {
-//   if (this->items.begin()->is<Object *>()) {
-//     this->items.remove_if([](Utils::Object *obj) {
-//       delete obj;
-//       return true;
-//     });
-//   }
-// }
+size_t Array_t::getElementSize(const int &atype) {
+  switch (atype) {
+    case Reference::kT_BOOLEAN:
+    case Reference::kT_BYTE:
+      return sizeof(int8_t);
+    case Reference::kT_CHAR:
+      return sizeof(uint16_t);
+    case Reference::kT_SHORT:
+      return sizeof(int16_t);
+    case Reference::kT_INT:
+      return sizeof(int);
+    case Reference::kT_FLOAT:
+      return sizeof(float);
+    case Reference::kT_LONG:
+      return sizeof(long);
+    case Reference::kT_DOUBLE:
+      return sizeof(double);
+  }
+  // qualquer outro tipo é um array de referencias
+  return sizeof(Object *);
+}
+
+Array_t::Array_t(const int &length, const int &atype) {
+  // newarray e anewarray já lançaram a NegativeArraySizeException
+  if (length < 0) {
+    throw Utils::Errors::Exception(Utils::Errors::kINSTRUCTION,
+                                   "negative array size");
+  }
+  this->size = length;
+  this->type = atype;
+  this->element_size = getElementSize(atype);
+  this->references =
+      atype < Reference::kT_BOOLEAN || atype > Reference::kT_LONG;
+  this->block = std::make_shared<std::vector<Types::u1>>(
+      length * this->element_size);
+  this->items = this->block->data();
+}
+
+Array_t::Array_t(const int &length, const int &atype,
+                 const std::shared_ptr<std::vector<Types::u1>> &block,
+                 const size_t &offset) {
+  this->size = length;
+  this->type = atype;
+  this->element_size = getElementSize(atype);
+  this->references =
+      atype < Reference::kT_BOOLEAN || atype > Reference::kT_LONG;
+  this->block = block;
+  this->items = block->data() + offset;
+}
 
-MultiArray_t::MultiArray_t(const int &dims, int *dims_sizes) {
-  this->arrays = new Array_t(dims_sizes[0]);
-  for (int i = 0; i < dims - 1; ++i) {
-    auto count = dims_sizes[i];
-    for (int d = 0; d < count; ++d) {
-      auto arrayobj = new Object(
-          new Array_t(dims_sizes[i + 1], Utils::Reference::kREF_ARRAY),
-          "internal_array");
-      this->arrays->insert(arrayobj, d);
-    }
+int Array_t::getType(const std::string &descriptor) {
+  switch (descriptor[descriptor.find_first_not_of('[')]) {
+    case 'Z':
+      return Reference::kT_BOOLEAN;
+    case 'B':
+      return Reference::kT_BYTE;
+    case 'C':
+      return Reference::kT_CHAR;
+    case 'S':
+      return Reference::kT_SHORT;
+    case 'I':
+      return Reference::kT_INT;
+    case 'F':
+      return Reference::kT_FLOAT;
+    case 'J':
+      return Reference::kT_LONG;
+    case 'D':
+      return Reference::kT_DOUBLE;
   }
+  return Reference::kREF_CLASS;
 }
 
-MultiArray_t::~MultiArray_t() {
-  this->arrays->getCollection().remove_if([](Utils::Object *obj) {
-    delete obj;
-    return true;
-  });
-  delete this->arrays;
+std::string Array_t::getDescriptor(const int &atype) {
+  switch (atype) {
+    case Reference::kT_BOOLEAN:
+      return "[Z";
+    case Reference::kT_BYTE:
+      return "[B";
+    case Reference::kT_CHAR:
+      return "[C";
+    case Reference::kT_SHORT:
+      return "[S";
+    case Reference::kT_INT:
+      return "[I";
+    case Reference::kT_FLOAT:
+      return "[F";
+    case Reference::kT_LONG:
+      return "[J";
+    case Reference::kT_DOUBLE:
+      return "[D";
+  }
+  // qualquer outro tipo é um array de referencias
+  return "[Ljava/lang/Object;";
 }
 }  // namespace Utils
@@ -31,7 +31,7 @@ std::string getConstantTypename(const Types::u1 &ct) {
   return names.at(ct);
 }
 // ----------------------------------------------------------------------------
-std::string CONSTANT_Class_info::getValue(
+const std::string &CONSTANT_Class_info::getValue(
     const std::vector<cp_info> &constpool) const {
   auto classname =
       constpool[this->name_index - 1].getClass<CONSTANT_Utf8_info>();
@@ -191,7 +191,7 @@ std::string CONSTANT_NameAndType_info::getGeneralInfo(
   return ss.str();
 }
 // ----------------------------------------------------------------------------
-std::string CONSTANT_String_info::getValue(
+const std::string &CONSTANT_String_info::getValue(
     const std::vector<cp_info> &constpool) const {
   auto string =
       constpool[this->string_index - 1].getClass<CONSTANT_Utf8_info>();
@@ -310,9 +310,11 @@ std::string CONSTANT_Double_info::getGeneralInfo(
   return ss.str();
 }
 // ----------------------------------------------------------------------------
-std::string CONSTANT_Utf8_info::getValue() const {
-  auto utf8_str = String::getUtf8Modified(this);
-  return utf8_str;
+const std::string &CONSTANT_Utf8_info::getValue() const {
+  if (!this->symbol) {
+    this->symbol = SymbolTable::intern(String::getUtf8Modified(this));
+  }
+  return *this->symbol;
 }
 
 std::string CONSTANT_Utf8_info::getGeneralInfo(const int &delta_tab) {
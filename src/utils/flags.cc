@@ -2,6 +2,7 @@
 
 #include <string.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <map>
 #include <regex>
@@ -17,7 +18,12 @@ static std::string getUsage() {
   std::stringstream ss;
   ss << "usage: ./jvm {mode} <path_to_class_file> <class_file> [options]\n"
      << "\tmode: viewer, interpreter\n"
-     << "\toptions: -v, -json, -d";
+     << "\toptions: -v, -json, -d, -t, -Xss<size>, -Xmx<size>, -Xmn<size>, "
+     << "-verbose:gc, -XX:+UseLargePages, -XX:ParallelGCThreads=<n>, "
+     << "-XX:+IncrementalMarking, -XX:MaxGCPauseMillis=<ms>, "
+     << "-XX:+ProfileAllocations, -XX:+HeapDumpOnOutOfMemoryError, "
+     << "-XX:+HeapDumpAtExit, -XX:HeapDumpPath=<path>, "
+     << "-XX:-StackTraceInThrowable";
 
   return ss.str();
 }
@@ -71,12 +77,85 @@ void toggleAll(const char **flags) {
   }
 }
 
+// tamanhos no formato da jvm da oracle: 512k, 4m, 1g ou so os bytes
+static size_t parseSize(const char *value, const char *flag) {
+  char *suffix = nullptr;
+  auto size = strtoull(value, &suffix, 10);
+  switch (*suffix) {
+    case 'g':
+    case 'G':
+      size *= 1024;
+    // fall through
+    case 'm':
+    case 'M':
+      size *= 1024;
+    // fall through
+    case 'k':
+    case 'K':
+      size *= 1024;
+      ++suffix;
+      break;
+  }
+  if (suffix == value || *suffix || !size) {
+    throw Errors::Exception(Errors::kFLAG,
+                            "invalid option: " + std::string(flag));
+  }
+  return size;
+}
+
+// valores inteiros das opções -XX:<nome>=<n>
+static size_t parseCount(const char *value, const char *flag) {
+  char *end = nullptr;
+  auto count = strtoull(value, &end, 10);
+  if (end == value || *end || !count) {
+    throw Errors::Exception(Errors::kFLAG,
+                            "invalid option: " + std::string(flag));
+  }
+  return count;
+}
+
 void toggle(const char *flag) {
+  if (!strncmp(flag, "-Xss", 4)) {
+    options.kSTACK_SIZE = parseSize(flag + 4, flag);
+    return;
+  }
+  if (!strncmp(flag, "-Xmx", 4)) {
+    options.kHEAP_SIZE = parseSize(flag + 4, flag);
+    return;
+  }
+  if (!strncmp(flag, "-Xmn", 4)) {
+    options.kYOUNG_SIZE = parseSize(flag + 4, flag);
+    return;
+  }
+  if (!strncmp(flag, "-XX:ParallelGCThreads=", 22)) {
+    options.kGC_THREADS = parseCount(flag + 22, flag);
+    return;
+  }
+  if (!strncmp(flag, "-XX:MaxGCPauseMillis=", 21)) {
+    options.kMAX_GC_PAUSE_MS = parseCount(flag + 21, flag);
+    return;
+  }
+  if (!strncmp(flag, "-XX:HeapDumpPath=", 17)) {
+    options.kHEAP_DUMP_PATH = flag + 17;
+    if (options.kHEAP_DUMP_PATH.empty()) {
+      throw Errors::Exception(Errors::kFLAG,
+                              "invalid option: " + std::string(flag));
+    }
+    return;
+  }
   static std::map<std::string, bool *> optionsNames = {
       {"-v", &options.kVERBOSE}, {"-verbose", &options.kVERBOSE},
       {"-i", &options.kIGNORE},  {"-ignore", &options.kIGNORE},
       {"-d", &options.kDEBUG},   {"-debug", &options.kDEBUG},
-      {"-json", &options.kJSON}};
+      {"-json", &options.kJSON},
+      {"-t", &options.kTHREADED}, {"-threaded", &options.kTHREADED},
+      {"-verbose:gc", &options.kVERBOSE_GC},
+      {"-XX:+UseLargePages", &options.kLARGE_PAGES},
+      {"-XX:+IncrementalMarking", &options.kINCREMENTAL_MARKING},
+      {"-XX:+ProfileAllocations", &options.kPROFILE_ALLOCATIONS},
+      {"-XX:+HeapDumpOnOutOfMemoryError", &options.kHEAP_DUMP_ON_OOM},
+      {"-XX:+HeapDumpAtExit", &options.kHEAP_DUMP_AT_EXIT},
+      {"-XX:-StackTraceInThrowable", &options.kSTACK_TRACE_IN_THROWABLE}};
   bool *f = nullptr;
   try {
     f = optionsNames.at(flag);
@@ -8,7 +8,8 @@
 
 namespace Utils {
 Attributes::attribute_info getAttribute(
-    const ClassFile *cf, std::vector<Attributes::attribute_info> *attributes,
+    const ClassFile *cf,
+    const std::vector<Attributes::attribute_info> *attributes,
     const std::string &attr_name) {
   auto attr =
       std::find_if(attributes->begin(), attributes->end(),
@@ -62,4 +63,23 @@ bool fieldIs(const Utils::Infos::field_info &field,
 
   return is;
 }
-}  // namespace Utils
\ No newline at end of file
+
+int getArgSlots(const std::string &descriptor) {
+  auto slots = 0;
+  for (auto it = descriptor.begin() + descriptor.find_first_of('(') + 1;
+       *it != ')'; ++it) {
+    auto is_array = false;
+    while (*it == '[') {
+      is_array = true;
+      ++it;
+    }
+    if (*it == 'L') {
+      while (*it != ';') {
+        ++it;
+      }
+    }
+    slots += (!is_array && (*it == 'D' || *it == 'J')) ? 2 : 1;
+  }
+  return slots;
+}
+}  // namespace Utils
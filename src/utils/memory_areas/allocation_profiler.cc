@@ -0,0 +1,113 @@
+#include "utils/memory_areas/allocation_profiler.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "utils/memory_areas/class_registry.h"
+#include "utils/runtime_class_t.h"
+
+namespace MemoryAreas {
+// classe, nome e descritor do metodo que está executando no frame
+static std::string getMethodName(Utils::Frame *frame) {
+  auto owner = frame->getRuntimeClass();
+  auto method = owner->findMethod(frame->getCode());
+  if (!method) {
+    return owner->name + ".<unknown>";
+  }
+  return owner->name + "." + *owner->getUtf8(method->name_index) +
+         *owner->getUtf8(method->descriptor_index);
+}
+
+// uma linha do relatorio
+struct ReportEntry {
+  std::string method;
+  int pc;
+  std::string klass;
+  AllocationProfiler::Count count;
+};
+
+// maiores primeiro, o resto desempata pro relatorio ser estavel
+static bool byBytes(const ReportEntry &a, const ReportEntry &b) {
+  if (a.count.bytes != b.count.bytes) {
+    return a.count.bytes > b.count.bytes;
+  }
+  return std::tie(a.klass, a.method, a.pc) < std::tie(b.klass, b.method, b.pc);
+}
+
+void AllocationProfiler::record(const Utils::Object *obj, const size_t &bytes,
+                                Utils::Frame *frame) {
+  auto &count = this->sites[{obj->klass, frame->getCode(), frame->pc}];
+  if (!count.objects && !this->methods.count(frame->getCode())) {
+    this->methods[frame->getCode()] = getMethodName(frame);
+  }
+  ++count.objects;
+  count.bytes += bytes;
+}
+
+void AllocationProfiler::merge(const AllocationProfiler &other) {
+  for (auto &site : other.sites) {
+    auto &count = this->sites[site.first];
+    count.objects += site.second.objects;
+    count.bytes += site.second.bytes;
+  }
+  this->methods.insert(other.methods.begin(), other.methods.end());
+}
+
+nlohmann::json AllocationProfiler::toJson() const {
+  Count total;
+  std::map<std::string, Count> by_class;
+  std::vector<ReportEntry> sites;
+  for (auto &site : this->sites) {
+    total.objects += site.second.objects;
+    total.bytes += site.second.bytes;
+    auto &class_count = by_class[*site.first.klass->name];
+    class_count.objects += site.second.objects;
+    class_count.bytes += site.second.bytes;
+    sites.push_back({this->methods.at(site.first.code), site.first.pc,
+                     *site.first.klass->name, site.second});
+  }
+  std::vector<ReportEntry> classes;
+  for (auto &entry : by_class) {
+    classes.push_back({"", 0, entry.first, entry.second});
+  }
+  std::sort(classes.begin(), classes.end(), byBytes);
+  std::sort(sites.begin(), sites.end(), byBytes);
+
+  nlohmann::json j;
+  j["objects"] = total.objects;
+  j["bytes"] = total.bytes;
+  j["classes"] = nlohmann::json::array();
+  for (auto &entry : classes) {
+    j["classes"].push_back({{"class", entry.klass},
+                            {"objects", entry.count.objects},
+                            {"bytes", entry.count.bytes}});
+  }
+  j["sites"] = nlohmann::json::array();
+  for (auto &entry : sites) {
+    j["sites"].push_back({{"method", entry.method},
+                          {"pc", entry.pc},
+                          {"class", entry.klass},
+                          {"objects", entry.count.objects},
+                          {"bytes", entry.count.bytes}});
+  }
+  return j;
+}
+
+void AllocationProfiler::report(std::ostream &out) const {
+  auto j = this->toJson();
+  out << "[Allocation profile: " << j["objects"] << " objects, " << j["bytes"]
+      << " bytes]\n";
+  for (auto &entry : j["classes"]) {
+    out << "[Allocations of " << entry["class"].get<std::string>() << ": "
+        << entry["objects"] << " objects, " << entry["bytes"] << " bytes]\n";
+  }
+  for (auto &entry : j["sites"]) {
+    out << "[Allocations at " << entry["method"].get<std::string>() << " pc "
+        << entry["pc"] << " (" << entry["class"].get<std::string>()
+        << "): " << entry["objects"] << " objects, " << entry["bytes"]
+        << " bytes]\n";
+  }
+}
+}  // namespace MemoryAreas
@@ -0,0 +1,90 @@
+#include "utils/memory_areas/arena.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace MemoryAreas {
+Arena::Arena(const bool &large_pages) {
+  this->block_top = nullptr;
+  this->block_end = nullptr;
+  this->large_pages = large_pages;
+  this->reserved_bytes = 0;
+}
+
+Arena::~Arena() {
+  for (auto block : this->blocks) {
+    std::free(block);
+  }
+}
+
+void *Arena::allocate(const size_t &size) {
+  auto index = (size + kALIGNMENT - 1) / kALIGNMENT - 1;
+  if (index >= kSIZE_CLASSES) {
+    return ::operator new(size);
+  }
+
+  auto size_class = &this->size_classes[index];
+  if (size_class->free_list) {
+    auto cell = size_class->free_list;
+    size_class->free_list = *static_cast<void **>(cell);
+    return cell;
+  }
+
+  auto cell_size = (index + 1) * kALIGNMENT;
+  if (size_class->top + cell_size > size_class->end) {
+    this->refill(size_class, cell_size);
+  }
+  auto cell = size_class->top;
+  size_class->top += cell_size;
+  return cell;
+}
+
+void Arena::free(void *cell, const size_t &size) {
+  auto index = (size + kALIGNMENT - 1) / kALIGNMENT - 1;
+  if (index >= kSIZE_CLASSES) {
+    ::operator delete(cell);
+    return;
+  }
+  auto size_class = &this->size_classes[index];
+  *static_cast<void **>(cell) = size_class->free_list;
+  size_class->free_list = cell;
+}
+
+void Arena::refill(SizeClass *size_class, const size_t &cell_size) {
+  if (this->block_top + kPAGE_SIZE > this->block_end) {
+    this->block_top = this->newBlock();
+    this->block_end = this->block_top + kBLOCK_SIZE;
+  }
+  // o que sobrou da pagina anterior não cabe mais nenhuma celula
+  size_class->top = this->block_top;
+  size_class->end = this->block_top + kPAGE_SIZE / cell_size * cell_size;
+  this->block_top += kPAGE_SIZE;
+}
+
+char *Arena::newBlock() {
+  void *block = nullptr;
+#if defined(_WIN32) || defined(WIN32)
+  block = std::malloc(kBLOCK_SIZE);
+#else
+  // alinhado ao tamanho do bloco pra poder virar uma unica huge page
+  if (posix_memalign(&block, kBLOCK_SIZE, kBLOCK_SIZE)) {
+    block = nullptr;
+  }
+#endif
+  if (!block) {
+    throw std::bad_alloc();
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (this->large_pages) {
+    madvise(block, kBLOCK_SIZE, MADV_HUGEPAGE);
+  }
+#endif
+  this->blocks.push_back(block);
+  this->reserved_bytes += kBLOCK_SIZE;
+  return static_cast<char *>(block);
+}
+}  // namespace MemoryAreas
@@ -0,0 +1,127 @@
+#include "utils/memory_areas/class_registry.h"
+
+#include <algorithm>
+
+#include "utils/errors.h"
+#include "utils/helper_functions.h"
+
+namespace MemoryAreas {
+// superclasse das exceções da biblioteca que podem aparecer num catch
+static const std::unordered_map<std::string, std::string> kLIBRARY_SUPERS = {
+    {"java/lang/Throwable", "java/lang/Object"},
+    {"java/lang/Exception", "java/lang/Throwable"},
+    {"java/lang/Error", "java/lang/Throwable"},
+    {"java/lang/RuntimeException", "java/lang/Exception"},
+    {"java/lang/InterruptedException", "java/lang/Exception"},
+    {"java/lang/CloneNotSupportedException", "java/lang/Exception"},
+    {"java/lang/ReflectiveOperationException", "java/lang/Exception"},
+    {"java/lang/ClassNotFoundException",
+     "java/lang/ReflectiveOperationException"},
+    {"java/io/IOException", "java/lang/Exception"},
+    {"java/lang/ArithmeticException", "java/lang/RuntimeException"},
+    {"java/lang/ArrayStoreException", "java/lang/RuntimeException"},
+    {"java/lang/ClassCastException", "java/lang/RuntimeException"},
+    {"java/lang/IllegalArgumentException", "java/lang/RuntimeException"},
+    {"java/lang/IllegalStateException", "java/lang/RuntimeException"},
+    {"java/lang/IndexOutOfBoundsException", "java/lang/RuntimeException"},
+    {"java/lang/NegativeArraySizeException", "java/lang/RuntimeException"},
+    {"java/lang/NullPointerException", "java/lang/RuntimeException"},
+    {"java/lang/UnsupportedOperationException", "java/lang/RuntimeException"},
+    {"java/lang/ArrayIndexOutOfBoundsException",
+     "java/lang/IndexOutOfBoundsException"},
+    {"java/lang/StringIndexOutOfBoundsException",
+     "java/lang/IndexOutOfBoundsException"},
+    {"java/lang/NumberFormatException", "java/lang/IllegalArgumentException"},
+    {"java/lang/AssertionError", "java/lang/Error"},
+    {"java/lang/LinkageError", "java/lang/Error"},
+    {"java/lang/IncompatibleClassChangeError", "java/lang/LinkageError"},
+    {"java/lang/VirtualMachineError", "java/lang/Error"},
+    {"java/lang/OutOfMemoryError", "java/lang/VirtualMachineError"},
+    {"java/lang/StackOverflowError", "java/lang/VirtualMachineError"}};
+
+ClassRegistry::~ClassRegistry() {
+  for (auto &entry : this->records) {
+    delete entry.second.runtime_class;
+    delete entry.second.statics;
+  }
+  for (auto cf : this->owned_classfiles) {
+    delete cf;
+  }
+}
+
+Utils::RuntimeClass_t *ClassRegistry::add(const ClassFile *cf,
+                                          const bool &owned) {
+  auto runtime_class = new Utils::RuntimeClass_t(cf);
+  auto record = this->get(runtime_class->name);
+  // o mesmo nome não é carregado duas vezes, mas o classfile de entrada pode
+  // chegar aqui depois de já ter sido lido de novo do disco
+  if (record->isLoaded()) {
+    delete runtime_class;
+    runtime_class = record->runtime_class;
+  } else {
+    record->runtime_class = runtime_class;
+    runtime_class->record = record;
+    if (cf->super_class) {
+      record->super =
+          this->get(runtime_class->getClassRef(cf->super_class)->name);
+    }
+    this->linkHandlers(runtime_class);
+  }
+  this->runtime_classes[cf] = runtime_class;
+  if (owned) {
+    this->owned_classfiles.push_back(cf);
+  }
+  return runtime_class;
+}
+
+void ClassRegistry::linkLibraryClass(ClassRecord *record) {
+  auto super = kLIBRARY_SUPERS.find(*record->name);
+  if (super != kLIBRARY_SUPERS.end()) {
+    record->super = this->get(super->second);
+  }
+}
+
+void ClassRegistry::linkHandlers(Utils::RuntimeClass_t *runtime_class) {
+  for (auto &method : runtime_class->methods) {
+    Utils::Attributes::Code_attribute *code;
+    try {
+      code = Utils::getAttribute(runtime_class->classfile, &method.attributes,
+                                 "Code")
+                 .getClass<Utils::Attributes::Code_attribute>();
+    } catch (const Utils::Errors::Exception &e) {
+      // metodos abstratos e nativos não tem bytecode
+      continue;
+    }
+    if (code->exception_table.empty()) {
+      continue;
+    }
+    // os intervalos das entradas se cruzam, então o código é cortado em
+    // cada start_pc e end_pc e cada pedaço guarda quem cobre ele inteiro
+    std::vector<int> bounds;
+    for (auto &entry : code->exception_table) {
+      bounds.push_back(entry.start_pc);
+      bounds.push_back(entry.end_pc);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    auto &table = runtime_class->handler_tables[code];
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      Utils::HandlerRange range{bounds[i], bounds[i + 1], {}};
+      for (auto &entry : code->exception_table) {
+        if (entry.start_pc <= range.start_pc && range.end_pc <= entry.end_pc) {
+          auto catch_class =
+              entry.catch_type
+                  ? this->get(runtime_class->getClassRef(entry.catch_type)
+                                  ->name)
+                  : nullptr;
+          range.handlers.push_back({entry.handler_pc, catch_class});
+        }
+      }
+      if (!range.handlers.empty()) {
+        table.push_back(std::move(range));
+      }
+    }
+  }
+}
+}  // namespace MemoryAreas
@@ -1,57 +1,1056 @@
 #include "utils/memory_areas/heap.h"
 
-#include "utils/access_flags.h"
+#include <chrono>
+#include <codecvt>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
 #include "utils/class_t.h"
-#include "utils/helper_functions.h"
+#include "utils/errors.h"
+#include "utils/fileSystem.h"
+#include "utils/flags.h"
 #include "utils/memory_areas/method_area.h"
+#include "utils/throwable_t.h"
 
 namespace MemoryAreas {
+// mesmo com o heap quase vazio o gc major não roda antes disso
+static const size_t kMIN_GC_THRESHOLD = 4 * 1024 * 1024;
+
+// a fatia da marcação incremental olha o relogio a cada tantos objetos
+static const size_t kSLICE_CHECK = 64;
+
+// o SIGUSR1 pede um heap dump, que é escrito na proxima alocação
+static volatile std::sig_atomic_t dump_requested = 0;
+
+static void requestDump(int signal) { dump_requested = 1; }
+
+static void outOfMemory() {
+  std::stringstream ss;
+  ss << "Out of memory. The heap has " << Utils::Flags::options.kHEAP_SIZE
+     << " bytes, use -Xmx to change it";
+  throw Utils::Errors::Exception(Utils::Errors::kHEAP, ss.str());
+}
+
+void CollectionStats::add(const double &pause_ms, const size_t &objects,
+                          const size_t &bytes) {
+  ++this->count;
+  this->freed_objects += objects;
+  this->freed_bytes += bytes;
+  this->addPause(pause_ms);
+}
+
+void CollectionStats::addPause(const double &pause_ms) {
+  static const double kBUCKET_LIMITS[kPAUSE_BUCKETS - 1] = {0.1, 1, 10, 100};
+  this->total_pause_ms += pause_ms;
+  this->max_pause_ms = std::max(this->max_pause_ms, pause_ms);
+  auto bucket = 0;
+  while (bucket < kPAUSE_BUCKETS - 1 && pause_ms >= kBUCKET_LIMITS[bucket]) {
+    ++bucket;
+  }
+  ++this->pauses[bucket];
+}
+
+Heap::Heap(ClassRegistry *classes)
+    : arena(Utils::Flags::options.kLARGE_PAGES) {
+  this->classes = classes;
+  this->epoch = 0;
+  this->marking = false;
+  this->allocated = 0;
+  this->next_gc =
+      std::min(kMIN_GC_THRESHOLD, Utils::Flags::options.kHEAP_SIZE);
+
+  // o nursery nunca ocupa mais que metade do heap
+  auto young_size =
+      alignCell(std::min(Utils::Flags::options.kYOUNG_SIZE,
+                         Utils::Flags::options.kHEAP_SIZE / 2));
+  this->nursery = static_cast<char *>(::operator new(young_size));
+  this->nursery_top = this->nursery;
+  this->nursery_end = this->nursery + young_size;
+  this->young_allocated = 0;
+  this->young_limit = young_size;
+  this->dumps = 0;
+  this->dumped_on_oom = false;
+#ifdef SIGUSR1
+  std::signal(SIGUSR1, requestDump);
+#endif
+}
+
+Heap::~Heap() {
+  if (Utils::Flags::options.kHEAP_DUMP_AT_EXIT) {
+    this->dump();
+  }
+  for (auto cell = this->nursery; cell < this->nursery_top;) {
+    auto obj = reinterpret_cast<Utils::Object *>(cell);
+    cell += alignCell(Heap::cellSize(obj));
+    obj->~Object();
+  }
+  ::operator delete(this->nursery);
+  for (auto obj : this->object_refs) {
+    this->destroy(obj);
+  }
+  if (Utils::Flags::options.kVERBOSE_GC) {
+    this->printSummary();
+  }
+}
+
+Utils::Object *Heap::newInstance(const Utils::RuntimeClass_t *runtime_class) {
+  auto &defaults = runtime_class->field_defaults;
+  auto cell = this->allocate(sizeof(Utils::Object) +
+                             defaults.size() * sizeof(Utils::Slot));
+  auto obj = new (cell) Utils::Object(runtime_class->record);
+  obj->field_count = defaults.size();
+  std::uninitialized_copy(defaults.begin(), defaults.end(), obj->getFields());
+  return this->track(obj);
+}
+
+Utils::Object *const *Heap::intern(Thread *th, const std::string &value) {
+  auto entry = this->interned.find(value);
+  if (entry != this->interned.end()) {
+    auto &interned = entry->second;
+    if (!interned.literal) {
+      // a string do String.intern passa a ser raiz, inclusive pra marcação
+      // que já está em andamento
+      interned.literal = true;
+      if (this->isYoung(interned.string)) {
+        this->young_interned.push_back(&interned.string);
+      } else if (this->marking) {
+        this->mark(interned.string);
+      }
+    }
+    return &interned.string;
+  }
+  // a alocação pode coletar, a entrada só entra no pool depois dela
+  auto obj = this->newObject(value, this->getRecord("java/lang/String"));
+  auto slot = &this->interned[value];
+  *slot = {obj, true};
+  if (this->isYoung(obj)) {
+    this->young_interned.push_back(&slot->string);
+  }
+  th->profileAllocation(obj);
+  return &slot->string;
+}
+
+Utils::Object *Heap::intern(Utils::Object *string) {
+  auto &value = string->data.as<std::string>();
+  auto entry = this->interned.find(value);
+  if (entry != this->interned.end()) {
+    // o pool não segura as do String.intern, então a marcação em andamento
+    // pode ainda não ter visto a string que a thread passa a alcançar
+    if (this->marking) {
+      this->mark(entry->second.string);
+    }
+    return entry->second.string;
+  }
+  auto inserted =
+      this->interned.emplace(value, InternedString{string, false}).first;
+  if (this->isYoung(string)) {
+    this->young_weak_interned.push_back(&inserted->first);
+  }
+  return string;
+}
+
+void Heap::dropDeadInterned() {
+  for (auto entry = this->interned.begin(); entry != this->interned.end();) {
+    auto obj = entry->second.string;
+    if (!entry->second.literal && !this->isYoung(obj) &&
+        obj->gc_epoch != this->epoch) {
+      entry = this->interned.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+void *Heap::allocate(const size_t &size) {
+  if (dump_requested) {
+    dump_requested = 0;
+    this->dump();
+  }
+  auto cell_size = alignCell(size);
+  // objetos grandes iriam encher o nursery sozinhos
+  if (cell_size > this->young_limit / 4) {
+    return this->arena.allocate(size);
+  }
+  if (this->nursery_top + cell_size > this->nursery_end ||
+      this->young_allocated > this->young_limit) {
+    this->collectYoung();
+    this->checkOldSpace(0);
+  }
+  auto cell = this->nursery_top;
+  this->nursery_top += cell_size;
+  return cell;
+}
+
+Utils::Object *Heap::track(Utils::Object *obj) {
+  auto size = Heap::sizeOf(obj);
+  if (this->isYoung(obj)) {
+    this->young_allocated += size;
+  } else {
+    try {
+      this->checkOldSpace(size);
+    } catch (const Utils::Errors::Exception &e) {
+      this->destroy(obj);
+      throw;
+    }
+  }
+  // não estava no snapshot da marcação, então já nasce marcado
+  if (this->marking) {
+    obj->gc_epoch = this->epoch;
+  }
+  if (this->isYoung(obj)) {
+    return obj;
+  }
+  this->object_refs.push_back(obj);
+  this->allocated += size;
+  return obj;
+}
+
+void Heap::checkOldSpace(const size_t &incoming) {
+  if (this->allocated + incoming <= this->next_gc) {
+    return;
+  }
+  // a major só enxerga o old space, então o nursery tem que estar vazio
+  if (this->nursery_top != this->nursery) {
+    this->collectYoung();
+  }
+  // ainda cabe, então a marcação continua junto com o programa
+  if (Utils::Flags::options.kINCREMENTAL_MARKING &&
+      this->allocated + incoming <= Utils::Flags::options.kHEAP_SIZE) {
+    if (!this->marking) {
+      this->startMarking();
+    }
+    this->stepMarking();
+    return;
+  }
+  this->collectOld();
+  if (this->allocated + incoming > Utils::Flags::options.kHEAP_SIZE) {
+    if (Utils::Flags::options.kHEAP_DUMP_ON_OOM && !this->dumped_on_oom) {
+      this->dumped_on_oom = true;
+      this->dump();
+    }
+    outOfMemory();
+  }
+}
+
+void Heap::collect() {
+  this->collectYoung();
+  this->collectOld();
+}
+
+void Heap::collectYoung() {
+  auto start = std::chrono::steady_clock::now();
+  auto young_before = this->young_allocated;
+  auto old_before = this->allocated;
+  auto objects_before = this->object_refs.size();
+
+  for (auto slot : this->young_interned) {
+    *slot = this->evacuate(*slot);
+  }
+  this->young_interned.clear();
+  for (auto th : this->threads) {
+    th->pending_exception = this->evacuate(th->pending_exception);
+    for (auto frame = th->getTopFrame(); frame; frame = frame->getCaller()) {
+      auto locals = frame->getLocalVariables();
+      for (auto i = 0; i < frame->getMaxLocals(); ++i) {
+        this->evacuate(&locals[i]);
+      }
+      for (auto slot = frame->getOperandStack(); slot < frame->getStackTop();
+           ++slot) {
+        this->evacuate(slot);
+      }
+    }
+  }
+  for (auto obj : this->remembered) {
+    obj->remembered = false;
+    this->scan(obj);
+  }
+  this->remembered.clear();
+  for (auto statics : this->remembered_statics) {
+    statics->remembered = false;
+    for (auto &field : statics->fields) {
+      this->evacuate(&field);
+    }
+  }
+  this->remembered_statics.clear();
+  // as copias são percorridas como numa busca em largura
+  while (!this->copied.empty()) {
+    auto obj = this->copied.back();
+    this->copied.pop_back();
+    this->scan(obj);
+  }
+  // as do String.intern que não foram copiadas morreram
+  for (auto text : this->young_weak_interned) {
+    auto entry = this->interned.find(*text);
+    if (entry->second.literal) {
+      continue;
+    }
+    if (entry->second.string->forwarded) {
+      entry->second.string = entry->second.string->forwardee;
+    } else {
+      this->interned.erase(entry);
+    }
+  }
+  this->young_weak_interned.clear();
+
+  // o que não foi copiado morreu, mas strings e arrays ainda tem que ser
+  // liberados pelo destrutor
+  size_t freed_objects = 0;
+  for (auto cell = this->nursery; cell < this->nursery_top;) {
+    auto obj = reinterpret_cast<Utils::Object *>(cell);
+    cell += alignCell(Heap::cellSize(obj));
+    if (!obj->forwarded) {
+      ++freed_objects;
+    }
+    obj->~Object();
+  }
+  this->nursery_top = this->nursery;
+  this->young_allocated = 0;
+
+  std::chrono::duration<double, std::milli> pause =
+      std::chrono::steady_clock::now() - start;
+  auto promoted_objects = this->object_refs.size() - objects_before;
+  auto promoted_bytes = this->allocated - old_before;
+  this->stats.promoted_objects += promoted_objects;
+  this->stats.promoted_bytes += promoted_bytes;
+  this->stats.minor.add(pause.count(), freed_objects,
+                        young_before - std::min(young_before, promoted_bytes));
+  if (Utils::Flags::options.kVERBOSE_GC) {
+    std::cerr << "[GC (minor) #" << this->stats.minor.count << ": young "
+              << young_before << "->0 bytes, " << promoted_objects
+              << " objects promoted, old " << this->allocated << "/"
+              << Utils::Flags::options.kHEAP_SIZE << " bytes, "
+              << freed_objects << " objects freed, " << pause.count()
+              << "ms]\n";
+  }
+}
+
+Utils::Object *Heap::evacuate(Utils::Object *obj) {
+  if (!this->isYoung(obj)) {
+    return obj;
+  }
+  if (obj->forwarded) {
+    return obj->forwardee;
+  }
+  auto cell = this->arena.allocate(Heap::cellSize(obj));
+  auto copy = new (cell) Utils::Object(std::move(*obj));
+  std::uninitialized_copy(obj->getFields(), obj->getFields() + obj->field_count,
+                          copy->getFields());
+  obj->forwarded = true;
+  obj->forwardee = copy;
+
+  this->object_refs.push_back(copy);
+  this->allocated += Heap::sizeOf(copy);
+  this->copied.push_back(copy);
+  return copy;
+}
+
+void Heap::evacuate(Utils::Slot *slot) {
+  if (slot->is<Utils::Object *>()) {
+    auto ref = slot->reference<Utils::Object *>();
+    *ref = this->evacuate(*ref);
+  }
+}
+
+void Heap::evacuate(Any *value) {
+  if (value->is<Utils::Object *>() &&
+      this->isYoung(value->as<Utils::Object *>())) {
+    *value = Any(this->evacuate(value->as<Utils::Object *>()));
+  }
+}
+
+void Heap::scan(Utils::Object *obj) {
+  auto fields = obj->getFields();
+  for (auto i = 0; i < obj->field_count; ++i) {
+    this->evacuate(&fields[i]);
+  }
+  if (obj->data.is<Utils::Array_t *>()) {
+    auto array = obj->data.as<Utils::Array_t *>();
+    for (auto i = 0; array->holdsReferences() && i < array->length(); ++i) {
+      auto ref = array->get<Utils::Object *>(i);
+      if (this->isYoung(ref)) {
+        array->insert(this->evacuate(ref), i);
+      }
+    }
+  } else if (obj->data.is<Utils::StringBuilder_t>()) {
+    auto &builder = obj->data.as<Utils::StringBuilder_t>();
+    builder.shared = this->evacuate(builder.shared);
+  } else {
+    this->evacuate(&obj->data);
+  }
+}
+
+void Heap::collectOld() {
+  auto start = std::chrono::steady_clock::now();
+  auto before = this->allocated;
+  auto objects_before = this->object_refs.size();
+
+  if (!this->marking) {
+    // trocar a epoca desmarca todos os objetos de uma vez, inclusive os que
+    // não estão registrados no heap (ex: os de um field estático default)
+    ++this->epoch;
+    this->markRoots();
+  }
+  if (Utils::Flags::options.kGC_THREADS > 1) {
+    this->traceParallel();
+  } else {
+    this->trace();
+  }
+  this->marking = false;
+  this->dropDeadInterned();
+  this->allocated = this->sweep();
+
+  // o limite cresce com o que sobreviveu pra não coletar a toda alocação
+  this->next_gc = std::min(std::max(kMIN_GC_THRESHOLD, this->allocated * 2),
+                           Utils::Flags::options.kHEAP_SIZE);
+
+  std::chrono::duration<double, std::milli> pause =
+      std::chrono::steady_clock::now() - start;
+  auto freed_objects = objects_before - this->object_refs.size();
+  this->stats.major.add(pause.count(), freed_objects,
+                        before - this->allocated);
+  if (Utils::Flags::options.kVERBOSE_GC) {
+    std::cerr << "[GC (major) #" << this->stats.major.count << ": old "
+              << before << "->" << this->allocated << "/"
+              << Utils::Flags::options.kHEAP_SIZE << " bytes, "
+              << freed_objects << " objects freed, " << pause.count()
+              << "ms]\n";
+  }
+}
+
+void Heap::startMarking() {
+  ++this->epoch;
+  this->markRoots();
+  this->marking = true;
+}
+
+void Heap::stepMarking() {
+  auto start = std::chrono::steady_clock::now();
+  auto deadline =
+      start + std::chrono::milliseconds(Utils::Flags::options.kMAX_GC_PAUSE_MS);
+  size_t traced = 0;
+  while (!this->gray.empty()) {
+    auto obj = this->gray.back();
+    this->gray.pop_back();
+    obj->forEachReference([this](Utils::Object *ref) { this->mark(ref); });
+    if (++traced % kSLICE_CHECK == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+
+  std::chrono::duration<double, std::milli> pause =
+      std::chrono::steady_clock::now() - start;
+  ++this->stats.mark_slices;
+  this->stats.major.addPause(pause.count());
+  if (Utils::Flags::options.kVERBOSE_GC) {
+    std::cerr << "[GC (mark slice) #" << this->stats.mark_slices << ": "
+              << traced << " objects traced, " << this->gray.size()
+              << " left, " << pause.count() << "ms]\n";
+  }
+  // o que sobrou no snapshot sem ser marcado é lixo
+  if (this->gray.empty()) {
+    this->collectOld();
+  }
+}
+
+void Heap::printSummary() {
+  static const char *kBUCKET_NAMES[kPAUSE_BUCKETS] = {
+      "<0.1ms", "<1ms", "<10ms", "<100ms", ">=100ms"};
+  auto print = [](const char *name, const CollectionStats &collections) {
+    std::cerr << "[GC summary (" << name << "): " << collections.count
+              << " collections, " << collections.freed_objects
+              << " objects and " << collections.freed_bytes
+              << " bytes freed, total pause " << collections.total_pause_ms
+              << "ms, max pause " << collections.max_pause_ms
+              << "ms, pauses";
+    for (auto i = 0; i < kPAUSE_BUCKETS; ++i) {
+      std::cerr << " " << kBUCKET_NAMES[i] << ":" << collections.pauses[i];
+    }
+    std::cerr << "]\n";
+  };
+  print("minor", this->stats.minor);
+  print("major", this->stats.major);
+  std::cerr << "[GC summary: " << this->stats.promoted_objects
+            << " objects and " << this->stats.promoted_bytes
+            << " bytes promoted, " << this->stats.mark_slices
+            << " incremental mark slices, old space at exit " << this->allocated << "/"
+            << Utils::Flags::options.kHEAP_SIZE << " bytes, arena "
+            << this->arena.reserved() << " bytes]\n";
+}
+
+void Heap::markRoots() {
+  for (auto &entry : this->interned) {
+    if (entry.second.literal) {
+      this->mark(entry.second.string);
+    }
+  }
+  for (auto th : this->threads) {
+    this->mark(th->pending_exception);
+    for (auto frame = th->getTopFrame(); frame; frame = frame->getCaller()) {
+      auto locals = frame->getLocalVariables();
+      for (auto i = 0; i < frame->getMaxLocals(); ++i) {
+        this->mark(locals[i]);
+      }
+      for (auto slot = frame->getOperandStack(); slot < frame->getStackTop();
+           ++slot) {
+        this->mark(*slot);
+      }
+    }
+  }
+  this->classes->forEach([this](ClassRecord *record) {
+    if (record->isInitialized()) {
+      for (auto &field : record->statics->fields) {
+        this->mark(field);
+      }
+    }
+  });
+}
+
+void Heap::trace() {
+  while (!this->gray.empty()) {
+    auto obj = this->gray.back();
+    this->gray.pop_back();
+    obj->forEachReference([this](Utils::Object *ref) { this->mark(ref); });
+  }
+}
+
+void Heap::traceParallel() {
+  auto count = Utils::Flags::options.kGC_THREADS;
+  std::vector<MarkQueue> queues(count);
+  for (size_t i = 0; i < this->gray.size(); ++i) {
+    queues[i % count].objects.push_back(this->gray[i]);
+  }
+  // objetos cinzas em todas as filas, a marcação acaba quando chega a 0
+  std::atomic<size_t> pending(this->gray.size());
+  this->gray.clear();
+
+  std::vector<std::thread> markers;
+  for (size_t id = 1; id < count; ++id) {
+    markers.emplace_back(&Heap::markWorker, this, &queues, id, &pending);
+  }
+  this->markWorker(&queues, 0, &pending);
+  for (auto &marker : markers) {
+    marker.join();
+  }
+}
+
+void Heap::markWorker(std::vector<MarkQueue> *queues, const size_t &id,
+                      std::atomic<size_t> *pending) {
+  auto &own = (*queues)[id];
+  std::vector<Utils::Object *> stolen;
+  while (pending->load()) {
+    Utils::Object *obj = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(own.lock);
+      if (!own.objects.empty()) {
+        obj = own.objects.back();
+        own.objects.pop_back();
+      }
+    }
+    // sem trabalho, rouba a metade mais antiga da fila de outra thread
+    for (size_t i = 1; !obj && i < queues->size(); ++i) {
+      auto &victim = (*queues)[(id + i) % queues->size()];
+      std::lock_guard<std::mutex> guard(victim.lock);
+      auto half = (victim.objects.size() + 1) / 2;
+      stolen.assign(victim.objects.begin(), victim.objects.begin() + half);
+      victim.objects.erase(victim.objects.begin(),
+                           victim.objects.begin() + half);
+      if (!stolen.empty()) {
+        obj = stolen.back();
+        stolen.pop_back();
+      }
+    }
+    if (!stolen.empty()) {
+      std::lock_guard<std::mutex> guard(own.lock);
+      own.objects.insert(own.objects.end(), stolen.begin(), stolen.end());
+      stolen.clear();
+    }
+    if (!obj) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    obj->forEachReference([this, &own, pending](Utils::Object *ref) {
+      if (ref && !this->isYoung(ref) && ref->tryMark(this->epoch)) {
+        pending->fetch_add(1);
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.objects.push_back(ref);
+      }
+    });
+    pending->fetch_sub(1);
+  }
+}
+
+size_t Heap::sweep() {
+  size_t live = 0;
+  auto kept = this->object_refs.begin();
+  for (auto obj : this->object_refs) {
+    if (obj->gc_epoch == this->epoch) {
+      live += Heap::sizeOf(obj);
+      *kept++ = obj;
+    } else {
+      this->destroy(obj);
+    }
+  }
+  this->object_refs.erase(kept, this->object_refs.end());
+  return live;
+}
+
+void Heap::mark(Utils::Object *obj) {
+  // os do nursery são da minor, que pode move-los durante a marcação
+  if (obj && !this->isYoung(obj) && obj->tryMark(this->epoch)) {
+    this->gray.push_back(obj);
+  }
+}
+
+void Heap::mark(const Utils::Slot &slot) {
+  if (slot.is<Utils::Object *>()) {
+    this->mark(slot.as<Utils::Object *>());
+  }
+}
+
+size_t Heap::sizeOf(Utils::Object *obj) {
+  // aproximado: o objeto, seus fields e o conteudo de strings e arrays
+  auto size =
+      sizeof(Utils::Object) + obj->field_count * sizeof(Utils::Slot);
+  if (obj->data.is<std::string>()) {
+    size += obj->data.as<std::string>().capacity();
+  } else if (obj->data.is<Utils::Array_t *>()) {
+    auto array = obj->data.as<Utils::Array_t *>();
+    size += sizeof(Utils::Array_t) + array->bytes();
+  } else if (obj->data.is<Utils::StringBuilder_t>()) {
+    size += obj->data.as<Utils::StringBuilder_t>().buffer.capacity();
+  } else if (obj->data.is<Utils::Throwable_t>()) {
+    auto &throwable = obj->data.as<Utils::Throwable_t>();
+    size += throwable.message.capacity() +
+            throwable.frames.capacity() * sizeof(Utils::TraceFrame);
+  }
+  return size;
+}
+
 void Heap::addClass(Thread *th, const std::string &classname) {
-  if (this->isInitialized(classname)) {
+  auto record = this->classes->get(classname);
+  if (record->isInitialized()) {
     return;
   }
-  this->initialized_classes.push_back(new Utils::Class_t(classname));
+  // as classes da biblioteca não são carregadas e não tem fields pra vm
+  if (classname.compare(0, 5, "java/")) {
+    auto runtime_class = th->method_area->getRuntimeClass(
+        th->method_area->getClass(classname));
+    th->method_area->layoutFields(runtime_class);
+    record->statics =
+        new Utils::Class_t(classname, runtime_class->static_defaults);
+  } else {
+    record->statics = new Utils::Class_t(classname, {});
+  }
   try {
     th->method_area->getMethod("<clinit>", "()V");
     th->changeContext(classname, "<clinit>", "()V", false);
   } catch (const Utils::Errors::Exception &e) {
-    for (auto &field : th->method_area->fields) {
-      if (Utils::fieldIs(field, "static")) {
-        Any default_val;
-        auto descriptor =
-            th->method_area->runtime_constant_pool[field.descriptor_index - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Utf8_info>()
-                ->getValue();
-        auto fname =
-            th->method_area->runtime_constant_pool[field.name_index - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Utf8_info>()
-                ->getValue();
-        auto classref = this->getClass(classname);
-        switch (descriptor[0]) {
-          case 'B':
-          case 'C':
-          case 'I':
-          case 'S':
-          case 'Z':
-            default_val = 0;
-            break;
-          case 'J':
-            default_val = 0L;
-            break;
-          case 'D':
-            default_val = 0.0;
-            break;
-          case 'F':
-            default_val = 0.0f;
-            break;
-          case 'L':
-            default_val = new Utils::Object(classname);
-            break;
-        }
-        classref->addField(default_val, fname, descriptor);
+  }
+}
+
+// o texto que a vm guarda no data dos objetos das classes da biblioteca
+static const std::string kTEXT_FIELD = "value";
+static const std::string kUNKNOWN_METHOD = "<unknown>";
+// stack trace vazio, onde todo objeto foi alocado
+static const Utils::Types::u4 kNO_TRACE = 1;
+
+// os fields de um objeto da classe no INSTANCE DUMP
+struct DumpLayout {
+  // slot e tipo de cada field, os da classe antes dos das superclasses. O
+  // slot -1 é o texto de uma classe da biblioteca
+  std::vector<std::pair<int, Utils::Types::u1>> values;
+  Utils::Types::u4 bytes = 0;
+};
+
+// tipo hprof de um field pelo descritor, os primitivos tem o valor do atype
+static Utils::Types::u1 getHprofType(const std::string &descriptor) {
+  auto type = Utils::Array_t::getType(descriptor);
+  return descriptor[0] == '[' || type == Utils::Reference::kREF_CLASS
+             ? kHPROF_OBJECT
+             : type;
+}
+
+static size_t getHprofSize(const Utils::Types::u1 &type) {
+  return type == kHPROF_OBJECT ? sizeof(void *)
+                               : Utils::Array_t::getElementSize(type);
+}
+
+static void writeValue(HprofWriter *hprof, const Utils::Types::u1 &type,
+                       const Utils::Slot &value) {
+  switch (type) {
+    case kHPROF_OBJECT:
+      hprof->writeId(value.is<Utils::Object *>()
+                         ? value.as<Utils::Object *>()
+                         : nullptr);
+      return;
+    case Utils::Reference::kT_LONG:
+      hprof->writeU8(value.is<long>() ? value.as<long>() : 0);
+      return;
+    case Utils::Reference::kT_FLOAT: {
+      auto f = value.is<float>() ? value.as<float>() : 0.0f;
+      Utils::Types::u4 bits;
+      std::memcpy(&bits, &f, sizeof(bits));
+      hprof->writeU4(bits);
+      return;
+    }
+    case Utils::Reference::kT_DOUBLE: {
+      auto d = value.is<double>() ? value.as<double>() : 0.0;
+      Utils::Types::u8 bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      hprof->writeU8(bits);
+      return;
+    }
+  }
+  auto i = value.is<int>() ? value.as<int>() : 0;
+  switch (getHprofSize(type)) {
+    case 1:
+      hprof->writeU1(i);
+      break;
+    case 2:
+      hprof->writeU2(i);
+      break;
+    default:
+      hprof->writeU4(i);
+  }
+}
+
+// o texto vira um char[], em utf-16 como na jvm
+static void writeText(HprofWriter *hprof, const void *id,
+                      const std::string &text) {
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> convert(
+      "", u"");
+  auto chars = convert.from_bytes(text);
+  if (chars.empty()) {
+    // não é utf-8 valido, vai byte a byte
+    for (auto c : text) {
+      chars.push_back(static_cast<unsigned char>(c));
+    }
+  }
+  hprof->beginSubRecord(kHPROF_PRIM_ARRAY_DUMP);
+  hprof->writeId(id);
+  hprof->writeU4(kNO_TRACE);
+  hprof->writeU4(chars.size());
+  hprof->writeU1(Utils::Reference::kT_CHAR);
+  for (auto c : chars) {
+    hprof->writeU2(c);
+  }
+}
+
+// como no layout dos fields, os das classes da biblioteca não contam
+static bool hasFields(const ClassRecord *record) {
+  return record->isLoaded() && record->runtime_class->laid_out &&
+         record->name->compare(0, 5, "java/");
+}
+
+// as classes da biblioteca tem só o texto no data
+static bool holdsText(const ClassRecord *record,
+                      const ClassRecord *object_class) {
+  return !hasFields(record) && record != object_class &&
+         (*record->name)[0] != '[';
+}
+
+// nullptr pro java/lang/Object, que é a raiz da hierarquia
+static ClassRecord *getSuper(ClassRegistry *classes, ClassRecord *record,
+                             ClassRecord *object_class) {
+  if (record == object_class) {
+    return nullptr;
+  }
+  if (!record->isLoaded() || !record->runtime_class->classfile->super_class) {
+    return object_class;
+  }
+  auto runtime_class = record->runtime_class;
+  auto &super_name =
+      runtime_class->constant_pool[runtime_class->classfile->super_class - 1]
+          .getClass<Utils::ConstantPool::CONSTANT_Class_info>()
+          ->getValue(runtime_class->constant_pool);
+  auto super = classes->find(super_name);
+  return super ? super : object_class;
+}
+
+// os fields de instancia que a classe declara, na ordem do classfile
+static std::vector<const Utils::Infos::field_info *> getInstanceFields(
+    const Utils::RuntimeClass_t *runtime_class) {
+  std::vector<const Utils::Infos::field_info *> fields;
+  for (auto &field : runtime_class->fields) {
+    if (!Utils::fieldIs(field, "static")) {
+      fields.push_back(&field);
+    }
+  }
+  return fields;
+}
+
+static const DumpLayout &getLayout(
+    std::unordered_map<const ClassRecord *, DumpLayout> *layouts,
+    ClassRegistry *classes, ClassRecord *record, ClassRecord *object_class) {
+  auto found = layouts->find(record);
+  if (found != layouts->end()) {
+    return found->second;
+  }
+  DumpLayout layout;
+  auto runtime_class = record->runtime_class;
+  if (hasFields(record)) {
+    auto fields = getInstanceFields(runtime_class);
+    // os fields declarados pela classe ficam nos ultimos slots
+    auto first = runtime_class->field_defaults.size() - fields.size();
+    for (size_t i = 0; i < fields.size(); ++i) {
+      layout.values.emplace_back(
+          first + i,
+          getHprofType(*runtime_class->getUtf8(fields[i]->descriptor_index)));
+    }
+  } else if (holdsText(record, object_class)) {
+    layout.values.emplace_back(-1, kHPROF_OBJECT);
+  }
+  auto super = getSuper(classes, record, object_class);
+  if (super) {
+    auto &inherited = getLayout(layouts, classes, super, object_class);
+    layout.values.insert(layout.values.end(), inherited.values.begin(),
+                         inherited.values.end());
+  }
+  for (auto &value : layout.values) {
+    layout.bytes += getHprofSize(value.second);
+  }
+  return (*layouts)[record] = layout;
+}
+
+static void writeClassDump(HprofWriter *hprof, ClassRecord *record,
+                           const ClassRecord *super, const DumpLayout &layout,
+                           const bool &text) {
+  hprof->beginSubRecord(kHPROF_CLASS_DUMP);
+  hprof->writeId(record);
+  hprof->writeU4(kNO_TRACE);
+  hprof->writeId(super);
+  // class loader, signers, protection domain e dois reservados
+  for (auto i = 0; i < 5; ++i) {
+    hprof->writeId(nullptr);
+  }
+  hprof->writeU4(layout.bytes);
+  // constant pool
+  hprof->writeU2(0);
+
+  auto runtime_class = record->runtime_class;
+  std::vector<const Utils::Infos::field_info *> static_fields;
+  for (size_t i = 0; runtime_class && i < runtime_class->fields.size(); ++i) {
+    if (Utils::fieldIs(runtime_class->fields[i], "static")) {
+      static_fields.push_back(&runtime_class->fields[i]);
+    }
+  }
+  hprof->writeU2(static_fields.size());
+  // os fields estáticos tem os slots na ordem do classfile
+  for (size_t slot = 0; slot < static_fields.size(); ++slot) {
+    auto field = static_fields[slot];
+    auto &descriptor = *runtime_class->getUtf8(field->descriptor_index);
+    auto type = getHprofType(descriptor);
+    hprof->writeId(runtime_class->getUtf8(field->name_index));
+    hprof->writeU1(type);
+    auto statics = record->statics;
+    writeValue(hprof, type,
+               statics && slot < statics->fields.size()
+                   ? statics->fields[slot]
+                   : Utils::Slot::defaultValue(descriptor[0]));
+  }
+
+  if (!hasFields(record)) {
+    hprof->writeU2(text ? 1 : 0);
+    if (text) {
+      hprof->writeId(&kTEXT_FIELD);
+      hprof->writeU1(kHPROF_OBJECT);
+    }
+    return;
+  }
+  auto instance_fields = getInstanceFields(runtime_class);
+  hprof->writeU2(instance_fields.size());
+  for (auto field : instance_fields) {
+    hprof->writeId(runtime_class->getUtf8(field->name_index));
+    hprof->writeU1(
+        getHprofType(*runtime_class->getUtf8(field->descriptor_index)));
+  }
+}
+
+static void writeObjectDump(HprofWriter *hprof, Utils::Object *obj,
+                            const DumpLayout &layout) {
+  if (obj->data.is<Utils::Array_t *>()) {
+    auto array = obj->data.as<Utils::Array_t *>();
+    auto references = array->holdsReferences();
+    hprof->beginSubRecord(references ? kHPROF_OBJ_ARRAY_DUMP
+                                     : kHPROF_PRIM_ARRAY_DUMP);
+    hprof->writeId(obj);
+    hprof->writeU4(kNO_TRACE);
+    hprof->writeU4(array->length());
+    if (references) {
+      hprof->writeId(obj->klass);
+      for (auto i = 0; i < array->length(); ++i) {
+        hprof->writeId(array->get<Utils::Object *>(i));
+      }
+      return;
+    }
+    hprof->writeU1(array->getType());
+    auto size = Utils::Array_t::getElementSize(array->getType());
+    for (auto i = 0; i < array->length(); ++i) {
+      switch (size) {
+        case 1:
+          hprof->writeU1(array->get<Utils::Types::u1>(i));
+          break;
+        case 2:
+          hprof->writeU2(array->get<Utils::Types::u2>(i));
+          break;
+        case 4:
+          hprof->writeU4(array->get<Utils::Types::u4>(i));
+          break;
+        default:
+          hprof->writeU8(array->get<Utils::Types::u8>(i));
       }
     }
     return;
   }
+
+  // o char[] do texto não é um objeto da vm, o id é o endereço do data
+  auto text = obj->data.is<std::string>() ? &obj->data : nullptr;
+  hprof->beginSubRecord(kHPROF_INSTANCE_DUMP);
+  hprof->writeId(obj);
+  hprof->writeU4(kNO_TRACE);
+  hprof->writeId(obj->klass);
+  hprof->writeU4(layout.bytes);
+  auto fields = obj->getFields();
+  auto has_text = false;
+  for (auto &value : layout.values) {
+    if (value.first < 0) {
+      hprof->writeId(text);
+      has_text = true;
+    } else {
+      writeValue(hprof, value.second,
+                 value.first < obj->field_count ? fields[value.first]
+                                                : Utils::Slot());
+    }
+  }
+  if (has_text && text) {
+    writeText(hprof, text, obj->data.as<std::string>());
+  }
+}
+
+void Heap::dump() {
+  auto path = Utils::Flags::options.kHEAP_DUMP_PATH;
+  if (path.empty()) {
+    const std::string outdir = "./.out/";
+    Utils::FileSystem::makeDirectory(outdir.c_str());
+    auto &file = Utils::Flags::options.kFILE;
+    path = outdir + file.substr(0, file.find_last_of('.')) + "_heap.hprof";
+  }
+  if (this->dumps) {
+    path += "." + std::to_string(this->dumps);
+  }
+  ++this->dumps;
+
+  auto start = std::chrono::steady_clock::now();
+  try {
+    HprofWriter hprof(path);
+    auto objects = this->writeDump(&hprof);
+    hprof.finish();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cerr << "[Heap dump " << path << ": " << objects << " objects, "
+              << hprof.size() << " bytes, " << elapsed.count() << "ms]\n";
+  } catch (const Utils::Errors::Exception &e) {
+    // o programa continua mesmo sem o dump
+    std::cerr << "[Heap dump failed: " << e.what() << "]\n";
+  }
+}
+
+size_t Heap::writeDump(HprofWriter *hprof) {
+  auto object_class = this->classes->get("java/lang/Object");
+  std::vector<ClassRecord *> records;
+  this->classes->forEach(
+      [&records](ClassRecord *record) { records.push_back(record); });
+
+  // os registros de fora do heap dump vem antes dele
+  std::unordered_map<const ClassRecord *, Utils::Types::u4> serials;
+  for (auto record : records) {
+    Utils::Types::u4 serial = serials.size() + 1;
+    serials[record] = serial;
+    hprof->writeLoadClass(serial, record, record->name);
+    if (record->isLoaded()) {
+      for (auto &field : record->runtime_class->fields) {
+        hprof->writeString(record->runtime_class->getUtf8(field.name_index));
+      }
+    }
+  }
+  hprof->writeString(&kTEXT_FIELD);
+  hprof->writeTrace(kNO_TRACE, 0, {});
+  for (size_t i = 0; i < this->threads.size(); ++i) {
+    std::vector<const void *> frames;
+    for (auto frame = this->threads[i]->getTopFrame(); frame;
+         frame = frame->getCaller()) {
+      auto owner = frame->getRuntimeClass();
+      auto method = owner->findMethod(frame->getCode());
+      auto serial = serials.find(owner->record);
+      hprof->writeFrame(
+          frame, method ? owner->getUtf8(method->name_index) : &kUNKNOWN_METHOD,
+          method ? owner->getUtf8(method->descriptor_index) : &kUNKNOWN_METHOD,
+          serial == serials.end() ? 0 : serial->second);
+      frames.push_back(frame);
+    }
+    hprof->writeTrace(kNO_TRACE + 1 + i, i + 1, frames);
+  }
+
+  // raizes: os slots dos frames, pelo numero do frame no stack trace
+  for (size_t i = 0; i < this->threads.size(); ++i) {
+    Utils::Types::u4 depth = 0;
+    auto root = [hprof, i, &depth](const Utils::Slot &slot) {
+      if (slot.is<Utils::Object *>() && slot.as<Utils::Object *>()) {
+        hprof->beginSubRecord(kHPROF_ROOT_JAVA_FRAME);
+        hprof->writeId(slot.as<Utils::Object *>());
+        hprof->writeU4(i + 1);
+        hprof->writeU4(depth);
+      }
+    };
+    // a exceção pendente fica com o frame do topo
+    root(Utils::Slot(this->threads[i]->pending_exception));
+    for (auto frame = this->threads[i]->getTopFrame(); frame;
+         frame = frame->getCaller(), ++depth) {
+      auto locals = frame->getLocalVariables();
+      for (auto j = 0; j < frame->getMaxLocals(); ++j) {
+        root(locals[j]);
+      }
+      for (auto slot = frame->getOperandStack(); slot < frame->getStackTop();
+           ++slot) {
+        root(*slot);
+      }
+    }
+  }
+
+  // os literais do pool de strings não tem um tipo de raiz no formato
+  for (auto &entry : this->interned) {
+    if (entry.second.literal) {
+      hprof->beginSubRecord(kHPROF_ROOT_UNKNOWN);
+      hprof->writeId(entry.second.string);
+    }
+  }
+
+  // e as classes, por onde os fields estáticos chegam nos objetos
+  std::unordered_map<const ClassRecord *, DumpLayout> layouts;
+  for (auto record : records) {
+    hprof->beginSubRecord(kHPROF_ROOT_STICKY_CLASS);
+    hprof->writeId(record);
+    writeClassDump(hprof, record,
+                   getSuper(this->classes, record, object_class),
+                   getLayout(&layouts, this->classes, record, object_class),
+                   holdsText(record, object_class));
+  }
+
+  size_t objects = 0;
+  this->forEachObject([&](Utils::Object *obj) {
+    writeObjectDump(
+        hprof, obj,
+        getLayout(&layouts, this->classes, obj->klass, object_class));
+    ++objects;
+  });
+  return objects;
 }
-}  // namespace MemoryAreas
\ No newline at end of file
+}  // namespace MemoryAreas
@@ -0,0 +1,118 @@
+#include "utils/memory_areas/hprof_writer.h"
+
+#include <chrono>
+
+#include "utils/errors.h"
+
+namespace MemoryAreas {
+// o tamanho de um registro tem 4 bytes, então o segmento é fechado antes
+static const size_t kMAX_SEGMENT = 1u << 30;
+
+// tag, tempo e tamanho
+static const int kRECORD_HEADER = 9;
+
+HprofWriter::HprofWriter(const std::string &path)
+    : out(path, std::ios::binary | std::ios::trunc) {
+  if (!this->out) {
+    throw Utils::Errors::Exception(Utils::Errors::kHEAP_DUMP,
+                                   "Error creating heap dump file " + path);
+  }
+  static const char kFORMAT[] = "JAVA PROFILE 1.0.2";
+  this->out.write(kFORMAT, sizeof(kFORMAT));
+  this->writeU4(sizeof(void *));
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+                 .count();
+  this->writeU8(now);
+}
+
+Utils::Types::u8 HprofWriter::writeString(const std::string *str) {
+  if (this->strings.insert(str).second) {
+    this->beginRecord(kHPROF_UTF8, sizeof(void *) + str->size());
+    this->writeId(str);
+    this->out.write(str->data(), str->size());
+  }
+  return reinterpret_cast<uintptr_t>(str);
+}
+
+void HprofWriter::writeLoadClass(const Utils::Types::u4 &serial,
+                                 const void *klass, const std::string *name) {
+  this->writeString(name);
+  this->beginRecord(kHPROF_LOAD_CLASS, 8 + 2 * sizeof(void *));
+  this->writeU4(serial);
+  this->writeId(klass);
+  // as classes não tem stack trace de quando foram carregadas
+  this->writeU4(0);
+  this->writeId(name);
+}
+
+void HprofWriter::writeFrame(const void *frame,
+                             const std::string *method_name,
+                             const std::string *descriptor,
+                             const Utils::Types::u4 &class_serial) {
+  this->writeString(method_name);
+  this->writeString(descriptor);
+  this->beginRecord(kHPROF_FRAME, 8 + 4 * sizeof(void *));
+  this->writeId(frame);
+  this->writeId(method_name);
+  this->writeId(descriptor);
+  // arquivo fonte e linha desconhecidos
+  this->writeId(nullptr);
+  this->writeU4(class_serial);
+  this->writeU4(0);
+}
+
+void HprofWriter::writeTrace(const Utils::Types::u4 &serial,
+                             const Utils::Types::u4 &thread_serial,
+                             const std::vector<const void *> &frames) {
+  this->beginRecord(kHPROF_TRACE, 12 + frames.size() * sizeof(void *));
+  this->writeU4(serial);
+  this->writeU4(thread_serial);
+  this->writeU4(frames.size());
+  for (auto frame : frames) {
+    this->writeId(frame);
+  }
+}
+
+void HprofWriter::beginSubRecord(const Utils::Types::u1 &tag) {
+  if (this->segment >= 0 &&
+      static_cast<size_t>(this->size() - this->segment) > kMAX_SEGMENT) {
+    this->closeSegment();
+  }
+  if (this->segment < 0) {
+    this->segment = this->out.tellp();
+    this->beginRecord(kHPROF_HEAP_DUMP_SEGMENT, 0);
+  }
+  this->writeU1(tag);
+}
+
+void HprofWriter::finish() {
+  this->closeSegment();
+  this->beginRecord(kHPROF_HEAP_DUMP_END, 0);
+  this->out.flush();
+  if (!this->out) {
+    throw Utils::Errors::Exception(Utils::Errors::kHEAP_DUMP,
+                                   "Error writing heap dump file");
+  }
+}
+
+void HprofWriter::beginRecord(const Utils::Types::u1 &tag,
+                              const Utils::Types::u4 &length) {
+  this->writeU1(tag);
+  // microssegundos desde o cabeçalho, que ninguém usa
+  this->writeU4(0);
+  this->writeU4(length);
+}
+
+void HprofWriter::closeSegment() {
+  if (this->segment < 0) {
+    return;
+  }
+  std::streamoff end = this->out.tellp();
+  // o tamanho fica depois da tag e do tempo
+  this->out.seekp(this->segment + 5);
+  this->writeU4(end - this->segment - kRECORD_HEADER);
+  this->out.seekp(end);
+  this->segment = -1;
+}
+}  // namespace MemoryAreas
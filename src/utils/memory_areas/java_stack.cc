@@ -0,0 +1,69 @@
+#include "utils/memory_areas/java_stack.h"
+
+#include <algorithm>
+#include <new>
+#include <sstream>
+
+#include "utils/attributes.h"
+#include "utils/errors.h"
+
+namespace MemoryAreas {
+// quantos slots o cabeçalho do frame ocupa na região
+static const size_t kFRAME_HEADER_SLOTS =
+    (sizeof(Utils::Frame) + sizeof(Utils::Slot) - 1) / sizeof(Utils::Slot);
+
+JavaStack::JavaStack(const size_t &size_in_bytes) {
+  this->capacity = size_in_bytes / sizeof(Utils::Slot);
+  this->region.reset(new Utils::Slot[this->capacity]);
+  this->top_frame = nullptr;
+  this->depth = 0;
+}
+
+Utils::Frame *JavaStack::push(Utils::RuntimeClass_t *runtime_class,
+                              Utils::Attributes::Code_attribute *code,
+                              const int &arg_slots) {
+  auto max_locals = code->max_locals;
+  auto max_stack = code->max_stack;
+  Utils::Slot *locals;
+  if (this->top_frame) {
+    // os argumentos já estão no topo da pilha do chamador, eles passam a ser
+    // as primeiras variaveis locais do novo frame
+    locals = this->top_frame->getStackTop() - arg_slots;
+    this->top_frame->setStackTop(locals);
+  } else {
+    locals = this->region.get();
+  }
+
+  // o valor de retorno é empilhado no chamador por cima das variaveis locais
+  // do frame que está retornando, então sempre sobra espaço pra um long ou
+  // double antes do cabeçalho
+  auto header = locals + std::max<int>(max_locals, 2);
+  auto operands = header + kFRAME_HEADER_SLOTS;
+  if (operands + max_stack > this->region.get() + this->capacity) {
+    if (this->top_frame) {
+      this->top_frame->setStackTop(locals + arg_slots);
+    }
+    std::stringstream ss;
+    ss << "Stack Overflow. The stack of this thread has "
+       << this->capacity * sizeof(Utils::Slot)
+       << " bytes, use -Xss to change it";
+    throw Utils::Errors::Exception(Utils::Errors::kSTACK, ss.str());
+  }
+
+  for (auto slot = locals + arg_slots; slot < header; ++slot) {
+    *slot = Utils::Slot();
+  }
+  this->top_frame =
+      new (header) Utils::Frame(runtime_class, code, locals, operands,
+                                max_locals, max_stack, this->top_frame);
+  ++this->depth;
+  return this->top_frame;
+}
+
+void JavaStack::pop() {
+  auto frame = this->top_frame;
+  this->top_frame = frame->getCaller();
+  frame->~Frame();
+  --this->depth;
+}
+}  // namespace MemoryAreas
@@ -10,25 +10,12 @@
 #include "utils/string.h"
 
 namespace MemoryAreas {
-Utils::Infos::method_info MethodArea::getMethod(const std::string &method_name,
-                                                const std::string &descriptor) {
-  auto method = std::find_if(
-      this->methods.begin(), this->methods.end(),
-      [&method_name, &descriptor,
-       this](const Utils::Infos::method_info &method) {
-        auto actual_method_name =
-            this->runtime_constant_pool[method.name_index - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Utf8_info>()
-                ->getValue();
-        auto actual_method_ret =
-            this->runtime_constant_pool[method.descriptor_index - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Utf8_info>()
-                ->getValue();
-        return !actual_method_name.compare(method_name) &&
-               !actual_method_ret.compare(descriptor);
-      });
-  if (method == this->methods.end()) {
-    auto classname = Utils::getClassName(this->runtime_classfile);
+const Utils::Infos::method_info &MethodArea::getMethod(
+    const Utils::RuntimeClass_t *owner, const std::string &method_name,
+    const std::string &descriptor) {
+  auto method = owner->findMethod(method_name, descriptor);
+  if (!method) {
+    auto classname = owner->name;
     std::stringstream ss;
     ss << "could not find method '" << method_name << ":" << descriptor
        << "' in class '" << classname << "'";
@@ -38,18 +25,22 @@ Utils::Infos::method_info MethodArea::getMethod(const std::string &method_name,
   return *method;
 }
 
-Utils::Infos::field_info MethodArea::getField(const std::string &field_name) {
-  auto field = std::find_if(
-      this->fields.begin(), this->fields.end(),
-      [&field_name, this](const Utils::Infos::field_info &field) {
-        auto actual_field_name =
-            this->runtime_constant_pool[field.name_index - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Utf8_info>()
-                ->getValue();
-        return !actual_field_name.compare(field_name);
-      });
-  if (field == this->fields.end()) {
-    auto classname = Utils::getClassName(this->runtime_classfile);
+Instructions::DecodedMethod *MethodArea::getDecodedMethod(
+    Utils::Attributes::Code_attribute *code_attr) {
+  auto method = this->decoded.find(code_attr);
+  if (method != this->decoded.end()) {
+    return method->second;
+  }
+  auto decoded_method = Instructions::decodeMethod(code_attr);
+  this->decoded[code_attr] = decoded_method;
+  return decoded_method;
+}
+
+const Utils::Infos::field_info &MethodArea::getField(
+    const Utils::RuntimeClass_t *owner, const std::string &field_name) {
+  auto field = owner->findField(field_name);
+  if (!field) {
+    auto classname = owner->name;
 
     std::stringstream ss;
     ss << "could not find field '" << field_name << "' in class '" << classname
@@ -60,19 +51,90 @@ Utils::Infos::field_info MethodArea::getField(const std::string &field_name) {
   return *field;
 }
 
-const ClassFile *MethodArea::getClass(const std::string &classname) {
-  if (!this->isLoaded(classname)) {
-    return this->loadClass(classname);
+void MethodArea::linkMethod(Utils::MethodRef_t *ref) {
+  ref->owner = this->getRuntimeClass(this->getClass(ref->class_name));
+  auto &method = this->getMethod(ref->owner, ref->method_name, ref->descriptor);
+  try {
+    ref->code = Utils::getAttribute(ref->owner->classfile, &method.attributes,
+                                    "Code")
+                    .getClass<Utils::Attributes::Code_attribute>();
+  } catch (const Utils::Errors::Exception &e) {
+    // metodos abstratos e nativos não tem bytecode
+    ref->code = nullptr;
+  }
+  ref->kind = Utils::kINVOKE_JAVA;
+}
+
+void MethodArea::linkInterfaceMethod(Utils::MethodRef_t *ref,
+                                     ClassRecord *receiver) {
+  for (auto klass = receiver; klass; klass = klass->super) {
+    if (!klass->isLoaded()) {
+      // as classes da biblioteca não implementam as interfaces do programa
+      if (!klass->name->compare(0, 5, "java/")) {
+        break;
+      }
+      this->getClass(*klass->name);
+    }
+    auto method =
+        klass->runtime_class->findMethod(ref->method_name, ref->descriptor);
+    if (method &&
+        !(method->access_flags & Utils::Access::MethodAccess::kACC_ABSTRACT)) {
+      ref->owner = klass->runtime_class;
+      ref->code = Utils::getAttribute(ref->owner->classfile,
+                                      &method->attributes, "Code")
+                      .getClass<Utils::Attributes::Code_attribute>();
+      ref->kind = Utils::kINVOKE_JAVA;
+      ref->receiver = receiver;
+      return;
+    }
   }
+  // nenhuma classe implementa, só resta o default da interface
+  this->linkMethod(ref);
+  ref->receiver = receiver;
+}
 
-  auto classfile = std::find_if(this->loaded.begin(), this->loaded.end(),
-                                [&classname](const ClassFile *classfile) {
-                                  auto actual_name =
-                                      Utils::getClassName(classfile);
-                                  return !classname.compare(actual_name);
-                                });
+void MethodArea::linkField(Utils::FieldRef_t *ref) {
+  auto owner = this->getRuntimeClass(this->getClass(ref->class_name));
+  this->layoutFields(owner);
+  ref->slot = owner->findFieldSlot(ref->field_name);
+  ref->is_static = ref->slot < 0;
+  if (ref->is_static) {
+    ref->slot = owner->findStaticSlot(ref->field_name);
+    // a classe não tem o field, getField lança o erro
+    if (ref->slot < 0) {
+      this->getField(owner, ref->field_name);
+    }
+  }
+  ref->resolved = true;
+}
 
-  return *classfile;
+void MethodArea::layoutFields(Utils::RuntimeClass_t *runtime_class) {
+  if (runtime_class->laid_out) {
+    return;
+  }
+  const Utils::RuntimeClass_t *super = nullptr;
+  auto super_index = runtime_class->classfile->super_class;
+  if (super_index) {
+    auto &super_name =
+        runtime_class->constant_pool[super_index - 1]
+            .getClass<Utils::ConstantPool::CONSTANT_Class_info>()
+            ->getValue(runtime_class->constant_pool);
+    // as classes da biblioteca não são carregadas e não tem fields pra vm
+    if (super_name.compare(0, 5, "java/")) {
+      auto super_class = this->getRuntimeClass(this->getClass(super_name));
+      this->layoutFields(super_class);
+      super = super_class;
+    }
+  }
+  runtime_class->layoutFields(super);
+}
+
+const ClassFile *MethodArea::getClass(const std::string &classname) {
+  auto record = this->classes->find(classname);
+  if (record && record->isLoaded()) {
+    return record->runtime_class->classfile;
+  }
+  return this->loadClass(classname);
 }
 
 // std::string MethodArea::getClassThatImplementsMethod(
@@ -110,8 +172,9 @@ const ClassFile *MethodArea::getClass(const std::string &classname) {
 // }
 
 const ClassFile *MethodArea::loadClass(const std::string &classname) {
-  if (this->isLoaded(classname)) {
-    return this->getClass(classname);
+  auto record = this->classes->find(classname);
+  if (record && record->isLoaded()) {
+    return record->runtime_class->classfile;
   }
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "Loading class " << classname << "\n";
@@ -134,7 +197,8 @@ const ClassFile *MethodArea::loadClass(const std::string &classname) {
     throw Utils::Errors::Exception(Utils::Errors::kCLASSFILE, e.what());
   }
 
-  this->loaded.push_back(new_class);
+  // os indices de metodos e fields são montados no carregamento
+  this->classes->add(new_class, true);
 
   return new_class;
 }
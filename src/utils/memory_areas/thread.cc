@@ -1,33 +1,54 @@
 #include "utils/memory_areas/thread.h"
 
+#include <pthread.h>
+
 #include <algorithm>
+#include <memory>
+#include <sstream>
 
 #include "instructions/execution_engine.h"
 #include "instructions/opcodes.h"
+#include "instructions/threaded_engine.h"
 #include "reader.h"
 #include "utils/attributes.h"
 #include "utils/errors.h"
 #include "utils/flags.h"
 #include "utils/helper_functions.h"
+#include "utils/memory_areas/class_registry.h"
 #include "utils/memory_areas/heap.h"
 #include "utils/memory_areas/method_area.h"
 #include "utils/string.h"
-
-#define MAX_STACK 40
+#include "utils/throwable_t.h"
 
 namespace MemoryAreas {
-void Thread::executeMethod(const std::string &method_name,
-                           const std::string &descriptor,
-                           const bool &popObjectRef) {
-  if (this->jvm_stack.size() > MAX_STACK) {
-    std::stringstream ss;
-    ss << "Stack Overflow. This jvm supports only " << MAX_STACK
-       << " methods calls at a time";
+// o que sobra da pilha nativa abaixo do ultimo frame java: o resto da
+// instrução, uma coleta ou a mensagem de erro
+static const size_t kNATIVE_STACK_RESERVE = 512 * 1024;
 
-    throw Utils::Errors::Exception(Utils::Errors::kSTACK, ss.str());
+const char *Thread::getNativeStackLimit() {
+#if defined(__linux__)
+  pthread_attr_t attr;
+  if (pthread_getattr_np(pthread_self(), &attr)) {
+    return nullptr;
+  }
+  void *stack_addr;
+  size_t stack_size;
+  auto failed = pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+  pthread_attr_destroy(&attr);
+  if (failed || stack_size <= kNATIVE_STACK_RESERVE) {
+    return nullptr;
   }
+  // a pilha cresce pra baixo, stack_addr é o fim dela
+  return static_cast<const char *>(stack_addr) + kNATIVE_STACK_RESERVE;
+#else
+  return nullptr;
+#endif
+}
 
-  auto method = this->method_area->getMethod(method_name, descriptor);
+void Thread::executeMethod(const std::string &method_name,
+                           const std::string &descriptor,
+                           const bool &popObjectRef) {
+  auto &method = this->method_area->getMethod(method_name, descriptor);
   this->current_method = method_name;
 
   Utils::Attributes::Code_attribute *code_attr;
@@ -40,87 +61,204 @@ void Thread::executeMethod(const std::string &method_name,
     std::cout << e.what() << "\n";
     return;
   }
-  auto code_array = code_attr->code;
 
+  // se ja tem um current frame, significa que teve troca de contexto e os
+  // argumentos estão no topo da pilha de operandos dele
+  auto arg_slots = 0;
+  if (this->current_frame) {
+    arg_slots = Utils::getArgSlots(descriptor) + (popObjectRef ? 1 : 0);
+  }
+  this->runMethod(method_name, code_attr, arg_slots);
+}
+
+void Thread::throwException(Utils::Object *obj) {
+  // relançar não muda o trace, que fica sendo o do primeiro athrow
+  if (Utils::Flags::options.kSTACK_TRACE_IN_THROWABLE &&
+      !obj->data.is<Utils::Throwable_t>()) {
+    Utils::Throwable_t throwable;
+    if (obj->data.is<std::string>()) {
+      throwable.message = obj->data.as<std::string>();
+    }
+    for (auto frame = this->jvm_stack.top(); frame;
+         frame = frame->getCaller()) {
+      throwable.frames.push_back(
+          {frame->getRuntimeClass(), frame->getCode(), frame->pc});
+    }
+    obj->data = std::move(throwable);
+  }
+  this->pending_exception = obj;
+}
+
+void Thread::throwNewException(const std::string &classname,
+                               const std::string &message) {
+  auto obj = this->heap->newObject(message, this->heap->getRecord(classname));
+  this->profileAllocation(obj);
+  this->throwException(obj);
+}
+
+Utils::Array_t *Thread::getArray(Utils::Object *arrayref, const int &index) {
+  if (!arrayref) {
+    this->throwNewException("java/lang/NullPointerException");
+    return nullptr;
+  }
+  auto array = arrayref->data.as<Utils::Array_t *>();
+  if (index < 0 || index >= array->length()) {
+    this->throwNewException(
+        "java/lang/ArrayIndexOutOfBoundsException",
+        "Index " + std::to_string(index) + " out of bounds for length " +
+            std::to_string(array->length()));
+    return nullptr;
+  }
+  return array;
+}
+
+void Thread::profileAllocation(Utils::Object *obj) {
+  if (Utils::Flags::options.kPROFILE_ALLOCATIONS) {
+    this->profiler.record(obj, Heap::sizeOf(obj), this->current_frame);
+  }
+}
+
+void Thread::runMethod(const std::string &method_name,
+                       Utils::Attributes::Code_attribute *code_attr,
+                       const int &arg_slots) {
   if (Utils::Flags::options.kDEBUG) {
     std::cout << "\tExecuting method " << method_name << "\n";
   }
+  if (this->native_stack_limit &&
+      static_cast<const char *>(__builtin_frame_address(0)) <
+          this->native_stack_limit) {
+    std::stringstream ss;
+    ss << "Stack Overflow. The native stack ran out after "
+       << this->jvm_stack.size() << " methods calls, use -Xss to change it";
+    throw Utils::Errors::Exception(Utils::Errors::kSTACK, ss.str());
+  }
 
-  auto newf = new Utils::Frame(code_attr->max_stack, code_attr->max_locals,
-                               this->method_area->runtime_constant_pool);
-  // se ja tem um current frame, significa que teve troca de contexto
-  if (this->current_frame) {
-    this->storeArguments(descriptor.substr(descriptor.find_first_of('(') + 1,
-                                           descriptor.find_last_of(')') - 1),
-                         newf, popObjectRef);
-  } else {
+  auto newf =
+      this->jvm_stack.push(this->method_area->runtime_class, code_attr,
+                           arg_slots);
+  if (!this->current_frame && !method_name.compare("main")) {
     auto args = Utils::String::split(Utils::Flags::options.kJVM_ARGS, ' ');
-    auto main_args =
-        new Utils::Array_t(args.size(), Utils::Reference::kREF_STRING);
-    auto this_obj =
-        new Utils::Object(main_args, Utils::getClassName(this->current_class));
+    std::unique_ptr<Utils::Array_t> args_data(
+        new Utils::Array_t(args.size(), Utils::Reference::kREF_STRING));
+    newf->pushLocalVar(
+        this->heap->newObject(args_data.get(),
+                              this->method_area->runtime_class->record),
+        0);
+    auto main_args = args_data.release();
+    // o array já está nas variaveis locais, então as strings podem disparar
+    // uma coleta sem que ele seja liberado. Ele pode ter sido promovido pela
+    // coleta, por isso o objeto é relido do frame pra barreira
+    auto string_record = this->heap->getRecord("java/lang/String");
     for (size_t i = 0; i < args.size(); ++i) {
-      main_args->insert(new Utils::Object(args[i], "java/lang/String"), i);
+      auto arg = this->heap->newObject(args[i], string_record);
+      main_args->insert(arg, i);
+      this->heap->writeBarrier(
+          newf->getLocalVariables()[0].as<Utils::Object *>(), nullptr, arg);
     }
-    newf->pushLocalVar(this->heap->pushReference(this_obj), 0);
   }
   this->current_frame = newf;
-  this->jvm_stack.push(this->current_frame);
 
-  for (auto it = code_array.begin(); it != code_array.end(); ++it) {
+  try {
+    if (Utils::Flags::options.kTHREADED) {
+      this->runDecoded(code_attr);
+    } else {
+      this->runBytecode(code_attr);
+    }
+  } catch (...) {
+    this->jvm_stack.pop();
+    throw;
+  }
+
+  this->jvm_stack.pop();
+}
+
+void Thread::runBytecode(Utils::Attributes::Code_attribute *code_attr) {
+  auto &code_array = code_attr->code;
+  auto it = code_array.begin();
+  while (it != code_array.end()) {
     if (Utils::Flags::options.kDEBUG) {
       std::cout << this->current_frame->pc << ": ";
     }
-    // tirei o try pra ficar mais fácil de debugar... mas ainda acho que vai
-    // precisar dps
-    try {
-      auto finish_method =
-          Instructions::runBytecode(&it, this, &this->current_frame->pc);
-      if (finish_method) {
-        break;
+    auto pc = this->current_frame->pc;
+    auto finish_method =
+        Instructions::runBytecode(&it, this, &this->current_frame->pc);
+    if (this->pending_exception) {
+      // a tabela de exceções é consultada com o pc da instrução que lançou
+      this->current_frame->pc = pc;
+      auto jumpto = this->catchPendingException(code_attr);
+      if (jumpto < 0) {
+        return;
       }
-    } catch (Utils::Object *obj) {
-      if (Utils::Flags::options.kDEBUG) {
-        std::cout << "Exception throwed by " << obj->class_name << "\n";
-      }
-      // acho que aqui seria onde teria o tratamento das excecoes da jvm????
-
-      auto attributes = this->current_class->attributes;
-      auto exception_table = code_attr->exception_table;
+      it = code_array.begin() + jumpto;
+      continue;
+    }
+    if (finish_method) {
+      break;
+    }
+    ++it;
+  }
+}
 
-      auto jumpto = 0;
-      for (auto it = exception_table.begin(); it != exception_table.end();
-           ++it) {
-        try {
-          auto exceptions = Utils::getAttribute(
-              this->current_class, &code_attr->attributes, "Exceptions");
-        } catch (const Utils::Errors::Exception &e) {
-        }
-        auto elem_class_name =
-            this->current_class->constant_pool[it->catch_type - 1]
-                .getClass<Utils::ConstantPool::CONSTANT_Class_info>()
-                ->getValue(this->method_area->runtime_constant_pool);
-        if (elem_class_name == obj->class_name) {
-          if (this->current_frame->pc > it->start_pc &&
-              this->current_frame->pc < it->end_pc) {
-            jumpto = it->handler_pc;
-            goto handle;
-          }
-        }
-      }
-      this->pushReturnValue(obj);
-      this->current_frame->cleanOperands();
-      throw obj;
-    handle:
-      it += (jumpto - this->current_frame->pc);
-      this->current_frame->pc += (jumpto - this->current_frame->pc);
-      this->current_frame->cleanOperands();
-      this->current_frame->pushOperand(obj);
+void Thread::runDecoded(Utils::Attributes::Code_attribute *code_attr) {
+  auto method = this->method_area->getDecodedMethod(code_attr);
+  auto start = 0;
+  while (true) {
+    // só retorna com uma exceção pendente se ela sair de alguma instrução, e
+    // nesse caso o pc do frame já é o da instrução
+    Instructions::runDecoded(method, this, start);
+    if (!this->pending_exception) {
+      return;
+    }
+    auto jumpto = this->catchPendingException(code_attr);
+    if (jumpto < 0) {
+      return;
     }
+    start = method->index_of_pc.at(jumpto);
   }
+}
 
-  this->jvm_stack.pop();
-  delete newf;
+int Thread::catchPendingException(
+    Utils::Attributes::Code_attribute *code_attr) {
+  auto obj = this->pending_exception;
+  if (Utils::Flags::options.kDEBUG) {
+    std::cout << "Exception throwed by " << *obj->klass->name << "\n";
+  }
+  auto jumpto = this->findExceptionHandler(code_attr, obj);
+  this->current_frame->cleanOperands();
+  if (jumpto < 0) {
+    // o metodo chamador procura o handler depois que o invoke retornar
+    return -1;
+  }
+  this->pending_exception = nullptr;
+  this->current_frame->pc = jumpto;
+  this->current_frame->pushOperand(obj);
+  return jumpto;
+}
+
+int Thread::findExceptionHandler(Utils::Attributes::Code_attribute *code_attr,
+                                 Utils::Object *obj) {
+  auto table =
+      this->current_frame->getRuntimeClass()->getHandlerTable(code_attr);
+  if (!table) {
+    return -1;
+  }
+  auto pc = this->current_frame->pc;
+  // o intervalo que pode cobrir o pc é o anterior ao primeiro que começa
+  // depois dele
+  auto range = std::upper_bound(
+      table->begin(), table->end(), pc,
+      [](const int &pc, const Utils::HandlerRange &range) {
+        return pc < range.start_pc;
+      });
+  if (range == table->begin() || pc >= (--range)->end_pc) {
+    return -1;
+  }
+  for (auto &handler : range->handlers) {
+    if (!handler.catch_class || obj->klass->isSubclassOf(handler.catch_class)) {
+      return handler.handler_pc;
+    }
+  }
+  return -1;
 }
 
 void Thread::changeContext(const std::string &classname,
@@ -154,105 +292,38 @@ void Thread::changeContext(const std::string &classname,
   this->method_area->update(this->current_class);
 }
 
-// Não consegui passar o iterator de forma normal, então copiei o tipo que o
-// VSCode deu
-template <typename T>
-static void insertLocalVar(MemoryAreas::Thread *th, Utils::Frame *frame,
-                           std::string args,
-                           std::string::const_reverse_iterator *it, int *index,
-                           const bool &JorD = false) {
-  if ((*it + 1) != args.rend() && *(*it + 1) == '[') {
-    ++*it;
-    frame->pushLocalVar(th->current_frame->popOperand<Utils::Object *>(),
-                        *index);
-  } else {
-    frame->pushLocalVar(th->current_frame->popOperand<T>(),
-                        JorD ? ((*index)-- - 1) : *index);
-  }
-}
-
-void Thread::storeArguments(const std::string &args, Utils::Frame *new_frame,
-                            const bool &popObjectRef) {
-  auto n_args = [](const std::string &args) -> int {
-    int args_count = 0;
-    for (auto it = args.begin(); it != args.end(); it++, ++args_count) {
-      switch (*it) {
-        case 'D':
-        case 'J':
-          ++args_count;
-          break;
-        case 'L':
-          while (*it != ';') {
-            ++it;
-          }
-          break;
-        case '[':
-          ++it;
-          if (*it == 'L') {
-            while (*it != ';') {
-              ++it;
-            }
-          }
-          break;
-      }
+void Thread::changeContext(Utils::MethodRef_t *ref,
+                           const bool &popObjectRef) {
+  auto old_class = this->current_class;
+  auto old_runtime_class = this->method_area->runtime_class;
+  if (ref->owner != old_runtime_class) {
+    if (Utils::Flags::options.kDEBUG &&
+        ref->owner->name.compare(old_runtime_class->name)) {
+      std::cout << "\tchanging context to " << ref->class_name << "."
+                << ref->method_name << ":" << ref->descriptor << "\n";
     }
-    return args_count;
-  }(args);
+    this->current_class = ref->owner->classfile;
+    this->method_area->runtime_class = ref->owner;
+  }
+  auto old_method = this->current_method;
+  auto old_frame = this->current_frame;
 
-  // isso faz com que qnd eu precisar popar o objectref a posição 0 fique vazia
-  auto start_index = popObjectRef ? n_args : n_args - 1;
+  if (!ref->code) {
+    std::cout << "could not find attribute Code\n";
+  } else {
+    this->current_method = ref->method_name;
+    this->runMethod(ref->method_name, ref->code,
+                    ref->arg_slots + (popObjectRef ? 1 : 0));
+  }
 
-  // o ultimo argumento da nova função ta no topo da pilha, entao a gente
-  // precisa inverter pra pegar os valores corretos
-  for (auto it = args.rbegin(); it != args.rend(); ++it, --start_index) {
-    // On instance method invocation, local variable 0 is always used to
-    // pass a reference to the object on which the instance method is being
-    // invoked
-    // ainda nao sei se isso ta 100% certo, mas deu certo nos meus pequenos
-    // testes
-    switch (*it) {
-      case 'D': {
-        insertLocalVar<double>(this, new_frame, args, &it, &start_index, true);
-        break;
-      }
-      case 'F': {
-        insertLocalVar<float>(this, new_frame, args, &it, &start_index);
-        break;
-      }
-      case 'J': {
-        insertLocalVar<long>(this, new_frame, args, &it, &start_index, true);
-        break;
-      }
-      case 'B':
-      case 'C':
-      case 'I':
-      case 'S':
-      case 'Z':
-        insertLocalVar<int>(this, new_frame, args, &it, &start_index);
-        break;
-      case ';': {
-        new_frame->pushLocalVar(
-            this->current_frame->popOperand<Utils::Object *>(), start_index);
-        while (*it != 'L') {
-          ++it;
-        }
-        if ((it + 1) != args.rend() && *(it + 1) == '[') {
-          ++it;
-        }
-        break;
-      }
-    }
-  };
+  this->current_class = old_class;
+  this->current_frame = old_frame;
+  this->current_method = old_method;
 
-  if (popObjectRef) {
-    auto objectref = this->current_frame->popOperand<Utils::Object *>();
-    // if (!objectref->class_name.empty() && objectref->class_name.compare(
-    //         Utils::getClassName(this->current_class))) {
-    //   throw std::invalid_argument(
-    //       "nao é aqui q tem que executar esse metodo, tem outra classe que "
-    //       "implementa");
-    // }
-    new_frame->pushLocalVar(objectref, start_index);
+  if (Utils::Flags::options.kDEBUG) {
+    std::cout << "\treturning context to " << old_runtime_class->name << "."
+              << this->current_method << "\n";
   }
+  this->method_area->runtime_class = old_runtime_class;
 }
 }  // namespace MemoryAreas
@@ -0,0 +1,24 @@
+#include "utils/symbol_table.h"
+
+#include <unordered_set>
+
+namespace Utils {
+namespace SymbolTable {
+// os nós de um unordered_set não mudam de endereço quando a tabela cresce
+static std::unordered_set<std::string> &symbols() {
+  static std::unordered_set<std::string> table;
+  return table;
+}
+
+Symbol intern(const std::string &value) {
+  return &*symbols().insert(value).first;
+}
+
+Symbol lookup(const std::string &value) {
+  auto symbol = symbols().find(value);
+  return symbol == symbols().end() ? nullptr : &*symbol;
+}
+
+size_t size() { return symbols().size(); }
+}  // namespace SymbolTable
+}  // namespace Utils
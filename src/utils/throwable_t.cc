@@ -0,0 +1,96 @@
+#include "utils/throwable_t.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "utils/errors.h"
+#include "utils/helper_functions.h"
+#include "utils/memory_areas/class_registry.h"
+#include "utils/object.h"
+#include "utils/runtime_class_t.h"
+
+namespace Utils {
+// -1 se o metodo não tem o atributo LineNumberTable
+static int getLineNumber(const TraceFrame &frame) {
+  Attributes::LineNumberTable_attribute *table;
+  try {
+    table = getAttribute(frame.owner->classfile, &frame.code->attributes,
+                         "LineNumberTable")
+                .getClass<Attributes::LineNumberTable_attribute>();
+  } catch (const Errors::Exception &e) {
+    return -1;
+  }
+  // a linha é a da entrada que começa mais perto antes do pc
+  auto start = -1;
+  auto line = -1;
+  for (auto &entry : table->line_number_table) {
+    if (entry.start_pc <= frame.pc && entry.start_pc > start) {
+      start = entry.start_pc;
+      line = entry.line_number;
+    }
+  }
+  return line;
+}
+
+// nullptr se a classe não tem o atributo SourceFile
+static const std::string *getSourceFile(const RuntimeClass_t *owner) {
+  try {
+    auto source = getAttribute(owner->classfile, &owner->classfile->attributes,
+                               "SourceFile")
+                      .getClass<Attributes::SourceFile_attribute>();
+    return owner->getUtf8(source->sourcefile_index);
+  } catch (const Errors::Exception &e) {
+    return nullptr;
+  }
+}
+
+std::string symbolize(const TraceFrame &frame) {
+  auto classname = frame.owner->name;
+  std::replace(classname.begin(), classname.end(), '/', '.');
+  auto method = frame.owner->findMethod(frame.code);
+
+  std::stringstream ss;
+  ss << classname << "."
+     << (method ? *frame.owner->getUtf8(method->name_index) : "<unknown>")
+     << "(";
+  auto source = getSourceFile(frame.owner);
+  if (!source) {
+    ss << "Unknown Source";
+  } else {
+    ss << *source;
+    auto line = getLineNumber(frame);
+    if (line >= 0) {
+      ss << ":" << line;
+    }
+  }
+  ss << ")";
+  return ss.str();
+}
+
+std::string getStackTraceText(Object *throwable) {
+  auto classname = *throwable->klass->name;
+  std::replace(classname.begin(), classname.end(), '/', '.');
+  const Throwable_t *thrown = nullptr;
+  std::string message;
+  if (throwable->data.is<Throwable_t>()) {
+    thrown = &throwable->data.as<Throwable_t>();
+    message = thrown->message;
+  } else if (throwable->data.is<std::string>()) {
+    message = throwable->data.as<std::string>();
+  }
+
+  std::stringstream ss;
+  ss << classname;
+  if (!message.empty()) {
+    ss << ": " << message;
+  }
+  ss << "\n";
+  // nunca foi lançado ou -XX:-StackTraceInThrowable
+  if (thrown) {
+    for (auto &frame : thrown->frames) {
+      ss << "\tat " << symbolize(frame) << "\n";
+    }
+  }
+  return ss.str();
+}
+}  // namespace Utils